@@ -0,0 +1,126 @@
+#include "mpmc_queue.hpp"
+#include "channel_mesh.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <string>
+#include <utility>
+
+using namespace mpmc_queue;
+
+struct alignas(64) ThreadStats {
+    size_t ops = 0;
+    size_t dummy = 0;
+};
+
+void pin_thread(int core_id) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+}
+
+// PushFn(producer, value) / PopFn(consumer, out) let every queue share one harness
+template <typename PushFn, typename PopFn>
+void run(const std::string& name, int num_producers, int num_consumers,
+         size_t items_per_producer, PushFn push, PopFn pop) {
+    const size_t total_items = num_producers * items_per_producer;
+
+    std::vector<ThreadStats> consumer_stats(num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> consumed_total{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            pin_thread(p);
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            for (size_t i = 0; i < items_per_producer; ++i) {
+                while (!push(p, static_cast<int>(i + p * items_per_producer))) _mm_pause();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            pin_thread(num_producers + c);
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            ThreadStats& stats = consumer_stats[c];
+            while (consumed_total.load(std::memory_order_relaxed) < total_items) {
+                int val;
+                if (pop(c, val)) {
+                    stats.ops++;
+                    stats.dummy += static_cast<size_t>(val);
+                    consumed_total.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _mm_pause();
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double duration_s = std::chrono::duration<double>(end - start).count();
+    size_t total_dummy = 0;
+    for (auto& s : consumer_stats) total_dummy += s.dummy;
+
+    std::cout << "==== " << num_producers << "P / " << num_consumers
+              << "C | " << name << " ====\n";
+    std::cout << "  Total items: " << total_items << "\n";
+    std::cout << "  Time: " << duration_s << " s\n";
+    std::cout << "  Throughput: " << std::fixed << std::setprecision(4)
+              << total_items / duration_s / 1e6 << " M items/sec\n";
+    std::cout << "  Avg latency: " << duration_s * 1e9 / total_items << " ns/item\n";
+    std::cout << "  Dummy sum: " << total_dummy << " (prevents optimization)\n\n";
+}
+
+int main() {
+    const size_t items_per_producer = 1'000'000;
+    const size_t capacity = 1 << 16;
+
+    // 2, 8 and 16 threads total
+    std::vector<std::pair<int, int>> configs = {{1, 1}, {4, 4}, {8, 8}};
+
+    for (auto& [p, c] : configs) {
+        {
+            MPMCQueue<int> q(capacity);
+            run("MPMCQueue", p, c, items_per_producer,
+                [&](int, int v) { return q.push(v); },
+                [&](int, int& out) { return q.pop(out); });
+        }
+        {
+            ShardedMPMCQueue<int> q(p, capacity / p);
+            run("ShardedMPMCQueue", p, c, items_per_producer,
+                [&](int, int v) { return q.push(v); },
+                [&](int, int& out) { return q.pop(out); });
+        }
+        {
+            ChannelMesh<int> mesh(p, c, capacity / (p * c));
+            run("ChannelMesh round-robin", p, c, items_per_producer,
+                [&](int id, int v) { return mesh.push(id, v); },
+                [&](int id, int& out) { return mesh.pop(id, out); });
+        }
+        {
+            ChannelMesh<int> mesh(p, c, capacity / (p * c));
+            run("ChannelMesh keyed", p, c, items_per_producer,
+                [&](int id, int v) { return mesh.push_keyed(id, v, v); },
+                [&](int id, int& out) { return mesh.pop(id, out); });
+        }
+        {
+            ChannelMesh<int> mesh(p, c, capacity / (p * c));
+            run("ChannelMesh least-loaded", p, c, items_per_producer,
+                [&](int id, int v) { return mesh.push_least_loaded(id, v); },
+                [&](int id, int& out) { return mesh.pop(id, out); });
+        }
+    }
+
+    return 0;
+}
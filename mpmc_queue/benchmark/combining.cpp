@@ -0,0 +1,94 @@
+#include "mpmc_queue.hpp"
+#include "combining_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+
+using namespace mpmc_queue;
+
+struct alignas(64) ThreadStats {
+    size_t dummy = 0;
+};
+
+// Half the threads push, half pop; total work is fixed so the curve shows
+// throughput as contention (and later oversubscription) grows
+template <typename Queue>
+double run(Queue& q, int threads, size_t total_items) {
+    const int num_producers = threads / 2;
+    const int num_consumers = threads - num_producers;
+    const size_t items_per_producer = total_items / num_producers;
+    const size_t pushed = items_per_producer * num_producers;
+
+    std::vector<ThreadStats> stats(num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> consumed_total{0};
+
+    std::vector<std::thread> workers;
+    for (int p = 0; p < num_producers; ++p) {
+        workers.emplace_back([&, p]() {
+            while (!start_flag.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t i = 0; i < items_per_producer; ++i) {
+                while (!q.push(static_cast<int>(i + p * items_per_producer))) _mm_pause();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        workers.emplace_back([&, c]() {
+            while (!start_flag.load(std::memory_order_acquire)) std::this_thread::yield();
+            while (consumed_total.load(std::memory_order_relaxed) < pushed) {
+                int val;
+                if (q.pop(val)) {
+                    stats[c].dummy += static_cast<size_t>(val);
+                    consumed_total.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _mm_pause();
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : workers) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return pushed / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+int main() {
+    const size_t total_items = 4'000'000;
+    const size_t capacity = 1 << 14;
+    const int hw = std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "Throughput in M items/sec, " << hw << " hardware threads\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "MPMCQueue"
+              << std::setw(12) << "adaptive" << std::setw(12) << "combining" << "\n";
+
+    // Powers of two plus hw and 2*hw, so full subscription and 2x
+    // oversubscription are measured even when hw is not a power of two
+    std::vector<int> sweep;
+    for (int threads = 2; threads < 2 * hw; threads *= 2) sweep.push_back(threads);
+    sweep.push_back(hw);
+    sweep.push_back(2 * hw);
+    std::sort(sweep.begin(), sweep.end());
+    sweep.erase(std::unique(sweep.begin(), sweep.end()), sweep.end());
+
+    for (int threads : sweep) {
+        MPMCQueue<int> plain(capacity);
+        CombiningMPMCQueue<int> adaptive(capacity, CombineMode::Adaptive);
+        CombiningMPMCQueue<int> always(capacity, CombineMode::Always);
+
+        std::cout << std::fixed << std::setprecision(4)
+                  << std::setw(8) << threads
+                  << std::setw(12) << run(plain, threads, total_items)
+                  << std::setw(12) << run(adaptive, threads, total_items)
+                  << std::setw(12) << run(always, threads, total_items) << "\n";
+    }
+
+    return 0;
+}
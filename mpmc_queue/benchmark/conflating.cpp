@@ -0,0 +1,102 @@
+#include "mpmc_queue.hpp"
+#include "conflating_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+
+using namespace mpmc_queue;
+using Clock = std::chrono::steady_clock;
+
+struct Quote {
+    uint64_t symbol;
+    int64_t published_ns;
+    double bid;
+    double ask;
+};
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+static void busy_work(std::chrono::nanoseconds d) {
+    auto until = Clock::now() + d;
+    while (Clock::now() < until) _mm_pause();
+}
+
+// Producers publish quotes over num_keys symbols as fast as the queue accepts
+// them for run_for; one slow consumer spends service_time per quote. Lag is
+// the age of a quote when the consumer gets to it.
+template <bool Conflate>
+void benchmark_feed(int num_producers, size_t num_keys, std::chrono::nanoseconds service_time,
+                    std::chrono::milliseconds run_for) {
+    ConflatingQueue<Quote> conflating(num_keys);
+    MPMCQueue<Quote> ring(1 << 16);
+
+    std::atomic<bool> stop{false};
+    std::vector<size_t> published(num_producers);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p]() {
+            size_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                Quote q{(n * num_producers + p) % num_keys, now_ns(), 1.0 * n, 1.0 * n + 0.5};
+                bool ok = Conflate ? conflating.push(q.symbol, q) : ring.push(q);
+                if (ok) ++n;
+                else _mm_pause();
+            }
+            published[p] = n;
+        });
+    }
+
+    std::vector<int64_t> lag;
+    lag.reserve(1 << 20);
+    auto start = Clock::now();
+    while (Clock::now() - start < run_for) {
+        uint64_t symbol;
+        Quote q;
+        bool ok = Conflate ? conflating.pop(symbol, q) : ring.pop(q);
+        if (!ok) continue;
+        lag.push_back(now_ns() - q.published_ns);
+        busy_work(service_time);
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& t : producers) t.join();
+    double duration_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t total_published = 0;
+    for (auto n : published) total_published += n;
+    std::sort(lag.begin(), lag.end());
+
+    std::cout << "==== " << num_producers << "P / 1C | " << num_keys << " keys | service "
+              << service_time.count() << " ns | "
+              << (Conflate ? "ConflatingQueue" : "MPMCQueue") << " ====\n";
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Producer rate: " << total_published / duration_s / 1e6 << " M updates/sec\n";
+    std::cout << "  Consumer rate: " << lag.size() / duration_s / 1e6 << " M updates/sec\n";
+    std::cout << std::setprecision(1);
+    if (!lag.empty()) {
+        std::cout << "  Consumer lag p50: " << lag[lag.size() / 2] / 1e3 << " us\n";
+        std::cout << "  Consumer lag p99: " << lag[lag.size() * 99 / 100] / 1e3 << " us\n";
+    }
+    std::cout << "\n";
+}
+
+int main() {
+    const auto run_for = std::chrono::milliseconds(1000);
+    const int producers = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    for (auto service : {std::chrono::nanoseconds(100), std::chrono::nanoseconds(1000),
+                         std::chrono::nanoseconds(10000)}) {
+        benchmark_feed<false>(producers, 1000, service, run_for);
+        benchmark_feed<true>(producers, 1000, service, run_for);
+    }
+
+    return 0;
+}
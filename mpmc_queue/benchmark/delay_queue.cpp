@@ -0,0 +1,92 @@
+#include "delay_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+
+using namespace mpmc_queue;
+using Clock = DelayQueue<int64_t>::Clock;
+
+static int64_t to_ns(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// Producers schedule timers spread over max_delay, consumers pop them as they
+// fire and record how late each one was relative to its deadline
+void benchmark_delay(int num_producers, int num_consumers, size_t timers_per_producer,
+                     std::chrono::milliseconds max_delay, Clock::duration tick) {
+    const size_t total = num_producers * timers_per_producer;
+    DelayQueue<int64_t> q(1 << 16, num_producers, tick);
+
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> fired{0};
+    std::vector<std::vector<int64_t>> lateness(num_consumers);
+    std::vector<double> insert_s(num_producers);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            std::mt19937_64 rng(p);
+            std::uniform_int_distribution<int64_t> delay(0, max_delay.count() * 1'000'000);
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            auto start = Clock::now();
+            for (size_t i = 0; i < timers_per_producer; ++i) {
+                auto due = start + std::chrono::nanoseconds(delay(rng));
+                q.push(to_ns(due), due);
+            }
+            insert_s[p] = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            lateness[c].reserve(total / num_consumers * 2);
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            while (fired.load(std::memory_order_relaxed) < total) {
+                int64_t due;
+                if (q.pop(due)) {
+                    lateness[c].push_back(to_ns(Clock::now()) - due);
+                    fired.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    double duration_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<int64_t> all;
+    for (auto& l : lateness) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    size_t early = std::lower_bound(all.begin(), all.end(), 0) - all.begin();
+    double slowest_insert = *std::max_element(insert_s.begin(), insert_s.end());
+
+    std::cout << "==== " << num_producers << "P / " << num_consumers << "C | "
+              << total << " timers over " << max_delay.count() << " ms | tick "
+              << std::chrono::duration_cast<std::chrono::microseconds>(tick).count() << " us ====\n";
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Insert throughput: " << total / slowest_insert / 1e6 << " M timers/sec\n";
+    std::cout << "  Fire throughput: " << total / duration_s / 1e6 << " M timers/sec\n";
+    std::cout << std::setprecision(1);
+    std::cout << "  Lateness p50: " << all[all.size() / 2] / 1e3 << " us\n";
+    std::cout << "  Lateness p99: " << all[all.size() * 99 / 100] / 1e3 << " us\n";
+    std::cout << "  Lateness max: " << all.back() / 1e3 << " us\n";
+    std::cout << "  Fired early: " << early << "\n\n";
+}
+
+int main() {
+    const int half = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    benchmark_delay(1, 1, 1'000'000, std::chrono::milliseconds(500), std::chrono::microseconds(100));
+    benchmark_delay(half, half, 1'000'000, std::chrono::milliseconds(1000), std::chrono::microseconds(100));
+    benchmark_delay(half, half, 1'000'000, std::chrono::milliseconds(1000), std::chrono::microseconds(10));
+
+    return 0;
+}
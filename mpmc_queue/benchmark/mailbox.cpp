@@ -0,0 +1,127 @@
+#include "mpmc_queue.hpp"
+#include "mailbox.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string>
+#include <malloc.h>
+
+using namespace mpmc_queue;
+
+struct Message : MailboxHook {
+    uint64_t actor;
+    uint64_t payload[3];
+};
+
+struct alignas(64) ThreadStats {
+    size_t dummy = 0;
+};
+
+// Heap bytes currently handed out by malloc, including mmapped blocks
+static size_t heap_in_use() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// Producers send to random actors; consumer c drains every actor with
+// id % num_consumers == c, which keeps each mailbox single-consumer
+template <typename Box, typename MakeBox, typename Send, typename Drain>
+void benchmark_actors(const std::string& name, size_t num_actors, int num_producers,
+                      int num_consumers, size_t msgs_per_producer,
+                      MakeBox make_box, Send send, Drain drain) {
+    const size_t total = num_producers * msgs_per_producer;
+
+    std::vector<std::vector<Message>> messages(num_producers);
+    for (int p = 0; p < num_producers; ++p) {
+        std::mt19937_64 rng(p);
+        messages[p].resize(msgs_per_producer);
+        for (size_t i = 0; i < msgs_per_producer; ++i) {
+            messages[p][i].actor = rng() % num_actors;
+            messages[p][i].payload[0] = i;
+        }
+    }
+
+    size_t heap_before = heap_in_use();
+    std::vector<std::unique_ptr<Box>> boxes;
+    boxes.reserve(num_actors);
+    for (size_t a = 0; a < num_actors; ++a) boxes.push_back(make_box());
+    size_t heap_after = heap_in_use();
+
+    std::vector<ThreadStats> stats(num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> received{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            for (Message& m : messages[p]) {
+                while (!send(*boxes[m.actor], m)) _mm_pause();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            while (received.load(std::memory_order_relaxed) < total) {
+                size_t n = 0;
+                for (size_t a = c; a < num_actors; a += num_consumers) {
+                    n += drain(*boxes[a], stats[c].dummy);
+                }
+                if (n) received.fetch_add(n, std::memory_order_relaxed);
+                else _mm_pause();
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double duration_s = std::chrono::duration<double>(end - start).count();
+    size_t total_dummy = 0;
+    for (auto& s : stats) total_dummy += s.dummy;
+
+    std::cout << "==== " << num_actors << " actors | " << num_producers << "P / "
+              << num_consumers << "C | " << name << " ====\n";
+    std::cout << "  sizeof(mailbox): " << sizeof(Box) << " B\n";
+    std::cout << "  Heap for mailboxes: " << (heap_after - heap_before) / 1024 << " KiB ("
+              << static_cast<double>(heap_after - heap_before) / num_actors << " B/actor)\n";
+    std::cout << "  Throughput: " << std::fixed << std::setprecision(4)
+              << total / duration_s / 1e6 << " M msgs/sec\n";
+    std::cout << "  Dummy sum: " << total_dummy << " (prevents optimization)\n\n";
+}
+
+int main() {
+    const size_t num_actors = 10'000;
+    const size_t msgs_per_producer = 1'000'000;
+    const size_t ring_capacity = 64;
+    const int half = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    using Box = Mailbox<Message>;
+
+    for (auto [p, c] : {std::pair{1, 1}, std::pair{half, half}}) {
+        benchmark_actors<MPMCQueue<Message>>(
+            "MPMCQueue per actor (64 slots)", num_actors, p, c, msgs_per_producer,
+            [&] { return std::make_unique<MPMCQueue<Message>>(ring_capacity); },
+            [](MPMCQueue<Message>& q, Message& m) { return q.push(m); },
+            [](MPMCQueue<Message>& q, size_t& sum) {
+                return q.consume_bulk([&](const Message& m) { sum += m.payload[0]; }, 32);
+            });
+        benchmark_actors<Box>(
+            "intrusive Mailbox", num_actors, p, c, msgs_per_producer,
+            [] { return std::make_unique<Box>(); },
+            [](Box& box, Message& m) { box.push(m); return true; },
+            [](Box& box, size_t& sum) {
+                return box.drain([&](Message& m) { sum += m.payload[0]; }, 32);
+            });
+    }
+
+    return 0;
+}
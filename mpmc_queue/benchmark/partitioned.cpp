@@ -0,0 +1,125 @@
+#include "mpmc_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace mpmc_queue;
+
+struct alignas(64) ThreadStats {
+    size_t ops = 0;
+    size_t dummy = 0;
+};
+
+// Pre-drawn Zipf(s) keys over [0, num_keys) so sampling stays off the hot path
+std::vector<uint32_t> zipf_keys(size_t count, size_t num_keys, double s, uint64_t seed) {
+    std::vector<double> cdf(num_keys);
+    double sum = 0;
+    for (size_t k = 0; k < num_keys; ++k) {
+        sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+        cdf[k] = sum;
+    }
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(0.0, sum);
+    std::vector<uint32_t> keys(count);
+    for (auto& k : keys) {
+        k = static_cast<uint32_t>(std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin());
+    }
+    return keys;
+}
+
+void benchmark_partitioned(bool partitioned, double zipf_s, int num_producers,
+                           int num_consumers, size_t items_per_producer) {
+    const size_t num_shards = 4 * num_consumers;
+    const size_t num_keys = 10'000;
+    const size_t total_items = num_producers * items_per_producer;
+
+    ShardedMPMCQueue<uint64_t> q(num_shards, 1 << 14);
+
+    std::vector<std::vector<uint32_t>> keys;
+    for (int p = 0; p < num_producers; ++p) {
+        keys.push_back(zipf_keys(items_per_producer, num_keys, zipf_s, p));
+    }
+
+    std::vector<ThreadStats> consumer_stats(num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> consumed_total{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            for (size_t i = 0; i < items_per_producer; ++i) {
+                uint32_t key = keys[p][i];
+                uint64_t item = (uint64_t(key) << 32) | i;
+                if (partitioned) {
+                    while (!q.push(key, item)) _mm_pause();
+                } else {
+                    while (!q.push(item)) _mm_pause();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            size_t id = partitioned ? q.join() : 0;
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            ThreadStats& stats = consumer_stats[c];
+            while (consumed_total.load(std::memory_order_relaxed) < total_items) {
+                uint64_t item;
+                bool ok = partitioned ? q.pop(id, item) : q.pop(item);
+                if (ok) {
+                    stats.ops++;
+                    stats.dummy += item;
+                    consumed_total.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _mm_pause();
+                }
+            }
+            if (partitioned) q.leave(id);
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double duration_s = std::chrono::duration<double>(end - start).count();
+    size_t total_dummy = 0, busiest = 0;
+    for (auto& s : consumer_stats) {
+        total_dummy += s.dummy;
+        busiest = std::max(busiest, s.ops);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "==== " << num_producers << "P / " << num_consumers << "C | zipf s="
+              << zipf_s << " | " << (partitioned ? "partitioned" : "round-robin") << " ====\n";
+    std::cout << "  Total items: " << total_items << "\n";
+    std::cout << "  Time: " << duration_s << " s\n";
+    std::cout << "  Throughput: " << std::setprecision(4)
+              << total_items / duration_s / 1e6 << " M items/sec\n";
+    std::cout << "  Busiest consumer share: " << std::setprecision(2)
+              << 100.0 * busiest / total_items << " %\n";
+    std::cout << "  Dummy sum: " << total_dummy << " (prevents optimization)\n\n";
+}
+
+int main() {
+    const size_t items_per_producer = 1'000'000;
+    const int half = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    for (int c : {1, 2, half}) {
+        for (double s : {0.0, 0.99, 1.2}) {
+            benchmark_partitioned(false, s, half, c, items_per_producer);
+            benchmark_partitioned(true, s, half, c, items_per_producer);
+        }
+    }
+
+    return 0;
+}
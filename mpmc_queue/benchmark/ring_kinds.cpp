@@ -0,0 +1,99 @@
+#include "mpmc_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+using namespace mpmc_queue;
+
+struct alignas(64) ThreadStats {
+    size_t dummy = 0;
+};
+
+constexpr size_t RING_CAPACITY = 1 << 14;
+
+template <typename Ring>
+std::unique_ptr<Ring> make_ring() {
+    if constexpr (std::is_default_constructible_v<Ring>) return std::make_unique<Ring>();
+    else return std::make_unique<Ring>(RING_CAPACITY);
+}
+
+template <Kind P, Kind C, size_t Capacity>
+void benchmark_ring(int multi_threads, size_t total_items) {
+    using Ring = BasicRing<int, P, C, Capacity>;
+    auto q = make_ring<Ring>();
+
+    const int num_producers = P == Kind::Single ? 1 : multi_threads;
+    const int num_consumers = C == Kind::Single ? 1 : multi_threads;
+    const size_t items_per_producer = total_items / num_producers;
+    const size_t pushed = items_per_producer * num_producers;
+
+    std::vector<ThreadStats> stats(num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> consumed_total{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            for (size_t i = 0; i < items_per_producer; ++i) {
+                while (!q->push(static_cast<int>(i + p * items_per_producer))) _mm_pause();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            while (consumed_total.load(std::memory_order_relaxed) < pushed) {
+                int val;
+                if (q->pop(val)) {
+                    stats[c].dummy += static_cast<size_t>(val);
+                    consumed_total.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _mm_pause();
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double duration_s = std::chrono::duration<double>(end - start).count();
+    size_t total_dummy = 0;
+    for (auto& s : stats) total_dummy += s.dummy;
+
+    std::cout << "==== " << (P == Kind::Single ? "SP" : "MP")
+              << (C == Kind::Single ? "SC" : "MC") << " | "
+              << (Capacity == DYNAMIC_CAPACITY ? "dynamic" : "static") << " capacity | "
+              << num_producers << "P / " << num_consumers << "C ====\n";
+    std::cout << "  Time: " << duration_s << " s\n";
+    std::cout << "  Throughput: " << std::fixed << std::setprecision(4)
+              << pushed / duration_s / 1e6 << " M items/sec\n";
+    std::cout << "  Avg latency: " << duration_s * 1e9 / pushed << " ns/item\n";
+    std::cout << "  Dummy sum: " << total_dummy << " (prevents optimization)\n\n";
+}
+
+template <Kind P, Kind C>
+void benchmark_kind(int multi_threads, size_t total_items) {
+    benchmark_ring<P, C, RING_CAPACITY>(multi_threads, total_items);
+    benchmark_ring<P, C, DYNAMIC_CAPACITY>(multi_threads, total_items);
+}
+
+int main() {
+    const size_t total_items = 10'000'000;
+    const int multi_threads = std::max(2u, std::thread::hardware_concurrency() / 4);
+
+    benchmark_kind<Kind::Single, Kind::Single>(multi_threads, total_items);
+    benchmark_kind<Kind::Multi, Kind::Single>(multi_threads, total_items);
+    benchmark_kind<Kind::Single, Kind::Multi>(multi_threads, total_items);
+    benchmark_kind<Kind::Multi, Kind::Multi>(multi_threads, total_items);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "mpmc_queue.hpp"
+#include "selector.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <ctime>
+
+using namespace mpmc_queue;
+using Clock = std::chrono::steady_clock;
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+static double thread_cpu_s() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// One paced producer spraying timestamps over num_queues queues; the consumer
+// either polls every queue round-robin or parks in a Selector.
+void benchmark_fan_in(bool use_selector, size_t num_queues, size_t num_messages,
+                      std::chrono::nanoseconds interval) {
+    std::vector<std::unique_ptr<MPMCQueue<uint64_t>>> queues;
+    Selector<uint64_t> sel(num_queues);
+    for (size_t i = 0; i < num_queues; ++i) {
+        queues.push_back(std::make_unique<MPMCQueue<uint64_t>>(1024));
+        sel.add(*queues.back());
+    }
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(num_messages);
+    double consumer_cpu = 0;
+
+    std::thread consumer([&]() {
+        double cpu_start = thread_cpu_s();
+        uint64_t stamp;
+        if (use_selector) {
+            while (latencies.size() < num_messages && sel.pop(stamp)) {
+                latencies.push_back(now_ns() - stamp);
+            }
+        } else {
+            size_t idx = 0;
+            while (latencies.size() < num_messages) {
+                if (queues[idx]->pop(stamp)) latencies.push_back(now_ns() - stamp);
+                idx = (idx + 1) % num_queues;
+            }
+        }
+        consumer_cpu = thread_cpu_s() - cpu_start;
+    });
+
+    std::mt19937_64 rng(42);
+    auto start = Clock::now();
+    auto next = start;
+    for (size_t i = 0; i < num_messages; ++i) {
+        next += interval;
+        while (Clock::now() < next) std::this_thread::yield();
+        size_t id = rng() % num_queues;
+        uint64_t stamp = now_ns();
+        while (!(use_selector ? sel.push(id, stamp) : queues[id]->push(stamp))) _mm_pause();
+    }
+    consumer.join();
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    double avg = 0;
+    for (auto l : latencies) avg += l;
+    avg /= latencies.size();
+
+    std::cout << "==== " << num_queues << " queues | "
+              << (use_selector ? "Selector" : "round-robin polling") << " ====\n";
+    std::cout << "  Messages: " << num_messages << "\n";
+    std::cout << "  Avg latency: " << std::fixed << std::setprecision(1) << avg << " ns\n";
+    std::cout << "  p50 latency: " << latencies[latencies.size() / 2] << " ns\n";
+    std::cout << "  p99 latency: " << latencies[latencies.size() * 99 / 100] << " ns\n";
+    std::cout << "  Consumer CPU: " << std::setprecision(2)
+              << 100.0 * consumer_cpu / wall << " %\n\n";
+}
+
+int main() {
+    const size_t num_messages = 200'000;
+    const auto interval = std::chrono::microseconds(5);
+
+    for (size_t n : {4, 16, 64, 256, 1024}) {
+        benchmark_fan_in(false, n, num_messages, interval);
+        benchmark_fan_in(true, n, num_messages, interval);
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "mpmc_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <string>
+#include <cstring>
+
+using namespace mpmc_queue;
+
+// Payload that counts every byte copied through its copy operations
+thread_local size_t bytes_copied = 0;
+
+template <size_t N>
+struct Payload {
+    uint64_t words[N / sizeof(uint64_t)];
+
+    Payload() = default;
+    Payload(const Payload& o) {
+        std::memcpy(words, o.words, sizeof(words));
+        bytes_copied += sizeof(words);
+    }
+    Payload& operator=(const Payload& o) {
+        std::memcpy(words, o.words, sizeof(words));
+        bytes_copied += sizeof(words);
+        return *this;
+    }
+};
+
+struct alignas(64) ThreadStats {
+    size_t bytes = 0;
+    size_t dummy = 0;
+};
+
+enum class Mode { Copy, InPlace, InPlaceBulk };
+
+template <size_t N>
+void benchmark_payload(Mode mode, int num_producers, int num_consumers,
+                       size_t items_per_producer) {
+    using T = Payload<N>;
+    constexpr size_t words = N / sizeof(uint64_t);
+    const size_t total_items = num_producers * items_per_producer;
+
+    MPMCQueue<T> q(1 << 14);
+    std::vector<ThreadStats> stats(num_producers + num_consumers);
+    std::atomic<bool> start_flag{false};
+    std::atomic<size_t> consumed_total{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            for (size_t i = 0; i < items_per_producer; ++i) {
+                if (mode == Mode::Copy) {
+                    T val;
+                    for (size_t w = 0; w < words; ++w) val.words[w] = i + w;
+                    while (!q.push(val)) _mm_pause();
+                } else {
+                    while (!q.push_with([&](T& slot) {
+                        for (size_t w = 0; w < words; ++w) slot.words[w] = i + w;
+                    })) _mm_pause();
+                }
+            }
+            stats[p].bytes = bytes_copied;
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            while (!start_flag.load(std::memory_order_acquire)) _mm_pause();
+            ThreadStats& s = stats[num_producers + c];
+            auto sum = [&](const T& v) {
+                for (size_t w = 0; w < words; ++w) s.dummy += v.words[w];
+            };
+            while (consumed_total.load(std::memory_order_relaxed) < total_items) {
+                size_t n = 0;
+                if (mode == Mode::Copy) {
+                    T val;
+                    if (q.pop(val)) {
+                        sum(val);
+                        n = 1;
+                    }
+                } else if (mode == Mode::InPlace) {
+                    n = q.consume(sum) ? 1 : 0;
+                } else {
+                    n = q.consume_bulk(sum, 32);
+                }
+                if (n) consumed_total.fetch_add(n, std::memory_order_relaxed);
+                else _mm_pause();
+            }
+            s.bytes = bytes_copied;
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_flag.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double duration_s = std::chrono::duration<double>(end - start).count();
+    size_t total_bytes = 0, total_dummy = 0;
+    for (auto& s : stats) {
+        total_bytes += s.bytes;
+        total_dummy += s.dummy;
+    }
+
+    const char* name = mode == Mode::Copy ? "push/pop (copy)"
+                     : mode == Mode::InPlace ? "push_with/consume"
+                     : "push_with/consume_bulk";
+    std::cout << "==== " << num_producers << "P / " << num_consumers << "C | "
+              << N << "B payload | " << name << " ====\n";
+    std::cout << "  Total items: " << total_items << "\n";
+    std::cout << "  Time: " << duration_s << " s\n";
+    std::cout << "  Throughput: " << std::fixed << std::setprecision(4)
+              << total_items / duration_s / 1e6 << " M items/sec\n";
+    std::cout << "  Bytes copied per message: "
+              << static_cast<double>(total_bytes) / total_items << "\n";
+    std::cout << "  Dummy sum: " << total_dummy << " (prevents optimization)\n\n";
+}
+
+template <size_t N>
+void benchmark_all_modes(int p, int c, size_t items_per_producer) {
+    benchmark_payload<N>(Mode::Copy, p, c, items_per_producer);
+    benchmark_payload<N>(Mode::InPlace, p, c, items_per_producer);
+    benchmark_payload<N>(Mode::InPlaceBulk, p, c, items_per_producer);
+}
+
+int main() {
+    const size_t items_per_producer = 1'000'000;
+    const int half = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    for (auto [p, c] : {std::pair{1, 1}, std::pair{half, half}}) {
+        benchmark_all_modes<64>(p, c, items_per_producer);
+        benchmark_all_modes<128>(p, c, items_per_producer);
+        benchmark_all_modes<256>(p, c, items_per_producer);
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+
+#include "mpmc_queue.hpp"
+#include "single.hpp"
+
+/*
+ * N x M mesh of SPSC rings
+ * - One SPSCQueue per (producer, consumer) pair, so no ring ever sees a shared RMW
+ * - Producers and consumers are identified by a fixed id in [0, N) / [0, M)
+ * - Each consumer polls only its own column of N rings
+ */
+
+namespace mpmc_queue {
+
+template <typename T>
+class ChannelMesh {
+private:
+    size_t numProducers_;
+    size_t numConsumers_;
+    size_t batch_;
+    std::vector<std::unique_ptr<SPSCQueue<T>>> rings_;
+
+    // Per-thread cursors, each on its own cache line
+    std::vector<PaddedIndex> producerCursor_;
+    std::vector<PaddedIndex> consumerCursor_;
+    std::vector<PaddedIndex> consumerBudget_;
+
+    SPSCQueue<T>& ring(size_t producer, size_t consumer) {
+        return *rings_[producer * numConsumers_ + consumer];
+    }
+
+public:
+    ChannelMesh(size_t numProducers, size_t numConsumers,
+                size_t capacityPerChannel, size_t batch = 32)
+        : numProducers_(numProducers),
+          numConsumers_(numConsumers),
+          batch_(batch),
+          producerCursor_(numProducers),
+          consumerCursor_(numConsumers),
+          consumerBudget_(numConsumers)
+    {
+        assert(numProducers_ > 0 && numConsumers_ > 0 && batch_ > 0);
+        rings_.reserve(numProducers_ * numConsumers_);
+        for (size_t i = 0; i < numProducers_ * numConsumers_; ++i) {
+            rings_.push_back(std::make_unique<SPSCQueue<T>>(capacityPerChannel));
+        }
+        for (auto& b : consumerBudget_) b.value = batch_;
+    }
+
+    ChannelMesh(const ChannelMesh&) = delete;
+    ChannelMesh& operator=(const ChannelMesh&) = delete;
+
+    size_t producers() const { return numProducers_; }
+    size_t consumers() const { return numConsumers_; }
+
+    // Round-robin across consumers; the cursor only advances on success so a
+    // full ring is retried on the next call rather than skipped.
+    bool push(size_t producer, const T& item) {
+        size_t& cursor = producerCursor_[producer].value;
+        for (size_t n = 0; n < numConsumers_; ++n) {
+            size_t c = (cursor + n) % numConsumers_;
+            if (ring(producer, c).push(item)) {
+                cursor = c + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Same key always lands on the same consumer, so per-key order holds
+    template <typename Key>
+    bool push_keyed(size_t producer, const Key& key, const T& item) {
+        size_t c = mix_hash(std::hash<Key>{}(key)) % numConsumers_;
+        return ring(producer, c).push(item);
+    }
+
+    // Picks the shallowest ring in this producer's row
+    bool push_least_loaded(size_t producer, const T& item) {
+        size_t& cursor = producerCursor_[producer].value;
+        size_t best = cursor % numConsumers_;
+        size_t bestSize = ring(producer, best).size();
+
+        for (size_t n = 1; n < numConsumers_ && bestSize > 0; ++n) {
+            size_t c = (cursor + n) % numConsumers_;
+            size_t sz = ring(producer, c).size();
+            if (sz < bestSize) {
+                best = c;
+                bestSize = sz;
+            }
+        }
+        cursor = best + 1;
+        return ring(producer, best).push(item);
+    }
+
+    // Stays on a ring for up to batch items before moving to the next one
+    // in the column, so a busy producer cannot starve the others.
+    bool pop(size_t consumer, T& out) {
+        size_t& cursor = consumerCursor_[consumer].value;
+        size_t& budget = consumerBudget_[consumer].value;
+
+        for (size_t n = 0; n < numProducers_; ++n) {
+            size_t p = cursor % numProducers_;
+            if (ring(p, consumer).pop(out)) {
+                if (--budget == 0) {
+                    budget = batch_;
+                    cursor = p + 1;
+                }
+                return true;
+            }
+            budget = batch_;
+            cursor = p + 1;
+        }
+        return false;
+    }
+
+    // Drains up to batch items from each ring in the column, round-robin,
+    // until max items have been collected or every ring is empty.
+    size_t pop_bulk(size_t consumer, T* out, size_t max) {
+        size_t& cursor = consumerCursor_[consumer].value;
+        size_t got = 0;
+        size_t idle = 0;
+
+        while (got < max && idle < numProducers_) {
+            size_t p = cursor % numProducers_;
+            size_t want = std::min(batch_, max - got);
+            size_t n = ring(p, consumer).pop_bulk(out + got, want);
+            got += n;
+            idle = n ? 0 : idle + 1;
+            cursor = p + 1;
+        }
+        consumerBudget_[consumer].value = batch_;
+        return got;
+    }
+};
+
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+
+#include "mpmc_queue.hpp"
+
+/*
+ * Flat-combining front end for MPMCQueue
+ * - A thread publishes its push/pop in a padded per-thread record
+ * - Whoever takes the combiner flag collects every pending record and applies
+ *   them as one bulk reservation per side (push_bulk_with / consume_bulk),
+ *   then hands results back through the records
+ * - In Adaptive mode each thread goes straight to the ring while its CAS
+ *   failure rate is low and switches to combining when it climbs
+ * - A thread claims its record on first use and keeps it until it exits, so the
+ *   per-op cost outside combining is one thread_local lookup
+ */
+
+namespace mpmc_queue {
+
+enum class CombineMode { Adaptive, Always, Never };
+
+template <typename T>
+class CombiningMPMCQueue {
+private:
+    enum State : uint32_t { FREE, OWNED, PUSH, POP, DONE };
+
+    // Failure EWMA is in 1/256ths of a CAS failure per op
+    static constexpr uint32_t COMBINE_ABOVE = 256;
+    static constexpr uint32_t DIRECT_BELOW = 64;
+    static constexpr uint32_t MAX_COUNTED_FAILURES = 16;
+    static constexpr uint32_t PROBE_INTERVAL = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Record {
+        std::atomic<uint32_t> state{FREE};
+        bool ok = false;
+        bool combining = false;
+        uint32_t failEwma = 0;
+        uint32_t ops = 0;
+        T value;
+    };
+
+    // Claims a thread holds across queues; released when the thread exits
+    struct ThreadRecords {
+        struct Claim {
+            uint64_t queue;
+            Record* record;
+        };
+        uint64_t lastQueue = 0;
+        Record* lastRecord = nullptr;
+        std::vector<Claim> claims;
+
+        ~ThreadRecords() {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            for (const Claim& c : claims) {
+                if (c.record && live_queues().count(c.queue)) {
+                    c.record->state.store(FREE, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    MPMCQueue<T> ring_;
+    CombineMode mode_;
+    uint64_t id_;
+    std::vector<Record> records_;
+    alignas(64) std::atomic<size_t> highWater_{0};
+    alignas(64) std::atomic<bool> combiner_{false};
+
+    // Combiner scratch, only touched while holding combiner_
+    std::vector<size_t> pushes_;
+    std::vector<size_t> pops_;
+
+    // Queue ids are never reused, so a claim can outlive its queue harmlessly
+    static std::mutex& registry_mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    static std::unordered_set<uint64_t>& live_queues() {
+        static std::unordered_set<uint64_t> ids;
+        return ids;
+    }
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static size_t thread_slot() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    static void backoff(int& spins) {
+        if (++spins < 20) _mm_pause();
+        else if (spins < 100) _mm_pause();
+        else if (spins < 1000) std::this_thread::yield();
+        else std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+
+    Record* claim_record() {
+        const size_t n = records_.size();
+        const size_t start = thread_slot();
+
+        for (size_t probe = 0; probe < n; ++probe) {
+            size_t i = (start + probe) % n;
+            uint32_t expected = FREE;
+            if (records_[i].state.load(std::memory_order_relaxed) == FREE &&
+                records_[i].state.compare_exchange_strong(expected, OWNED, std::memory_order_acquire)) {
+                size_t hw = highWater_.load(std::memory_order_relaxed);
+                while (hw <= i && !highWater_.compare_exchange_weak(hw, i + 1, std::memory_order_release)) {}
+                return &records_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Threads beyond maxRecords cache nullptr and stay on the direct path
+    Record* my_record() {
+        thread_local ThreadRecords mine;
+        if (mine.lastQueue == id_) return mine.lastRecord;
+
+        auto it = std::find_if(mine.claims.begin(), mine.claims.end(),
+                               [&](const auto& c) { return c.queue == id_; });
+        if (it == mine.claims.end()) {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            std::erase_if(mine.claims, [](const auto& c) { return !live_queues().count(c.queue); });
+            mine.claims.push_back({id_, claim_record()});
+            it = mine.claims.end() - 1;
+        }
+        mine.lastQueue = id_;
+        mine.lastRecord = it->record;
+        return it->record;
+    }
+
+    bool use_combining(Record& r) {
+        if (mode_ != CombineMode::Adaptive) return mode_ == CombineMode::Always;
+        // Combining threads never see a CAS fail, so probe the direct path now and then
+        return r.combining && ++r.ops % PROBE_INTERVAL != 0;
+    }
+
+    void record_failures(Record* r, uint32_t failures) {
+        if (!r) return;
+        uint32_t sample = std::min(failures, MAX_COUNTED_FAILURES) * 256;
+        r->failEwma = (r->failEwma * 7 + sample) / 8;
+        if (r->failEwma > COMBINE_ABOVE) r->combining = true;
+        else if (r->failEwma < DIRECT_BELOW) r->combining = false;
+    }
+
+    template <typename Attempt>
+    bool direct(Record* r, Attempt&& attempt) {
+        uint32_t failures = 0;
+        int spins = 0;
+        while (true) {
+            ClaimResult res = attempt();
+            if (res != ClaimResult::Contended) {
+                record_failures(r, failures);
+                return res == ClaimResult::Claimed;
+            }
+            ++failures;
+            backoff(spins);
+        }
+    }
+
+    void run_combiner() {
+        pushes_.clear();
+        pops_.clear();
+        size_t hw = highWater_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < hw; ++i) {
+            uint32_t s = records_[i].state.load(std::memory_order_acquire);
+            if (s == PUSH) pushes_.push_back(i);
+            else if (s == POP) pops_.push_back(i);
+        }
+
+        size_t pushed = 0;
+        while (pushed < pushes_.size()) {
+            size_t n = ring_.push_bulk_with([&](T& slot, size_t k) {
+                slot = records_[pushes_[pushed + k]].value;
+            }, pushes_.size() - pushed);
+            if (n == 0) break;
+            pushed += n;
+        }
+        for (size_t k = 0; k < pushes_.size(); ++k) {
+            Record& r = records_[pushes_[k]];
+            r.ok = k < pushed;
+            r.state.store(DONE, std::memory_order_release);
+        }
+
+        size_t popped = 0;
+        while (popped < pops_.size()) {
+            size_t n = ring_.consume_bulk([&](T& slot) {
+                records_[pops_[popped++]].value = slot;
+            }, pops_.size() - popped);
+            if (n == 0) break;
+        }
+        for (size_t k = 0; k < pops_.size(); ++k) {
+            Record& r = records_[pops_[k]];
+            r.ok = k < popped;
+            r.state.store(DONE, std::memory_order_release);
+        }
+    }
+
+    // Publishes the request, then either waits for a combiner to serve it or
+    // becomes the combiner itself
+    bool combine(Record& r, State op) {
+        r.state.store(op, std::memory_order_release);
+        int spins = 0;
+        while (r.state.load(std::memory_order_acquire) != DONE) {
+            if (!combiner_.load(std::memory_order_relaxed) &&
+                !combiner_.exchange(true, std::memory_order_acquire)) {
+                run_combiner();
+                combiner_.store(false, std::memory_order_release);
+                continue;
+            }
+            backoff(spins);
+        }
+        return r.ok;
+    }
+
+public:
+    explicit CombiningMPMCQueue(size_t capacity, CombineMode mode = CombineMode::Adaptive,
+                                size_t maxRecords = 64)
+        : ring_(capacity),
+          mode_(mode),
+          id_(next_id()),
+          records_(maxRecords)
+    {
+        assert(maxRecords > 0);
+        pushes_.reserve(maxRecords);
+        pops_.reserve(maxRecords);
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        live_queues().insert(id_);
+    }
+
+    ~CombiningMPMCQueue() {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        live_queues().erase(id_);
+    }
+
+    CombiningMPMCQueue(const CombiningMPMCQueue&) = delete;
+    CombiningMPMCQueue& operator=(const CombiningMPMCQueue&) = delete;
+
+    // Never mode is the bare ring; more threads than records fall back to the
+    // direct path
+    bool push(const T& item) {
+        if (mode_ == CombineMode::Never) return ring_.push(item);
+        Record* r = my_record();
+        if (r && use_combining(*r)) {
+            r->value = item;
+            return combine(*r, PUSH);
+        }
+        return direct(r, [&] { return ring_.try_push_with([&](T& slot) { slot = item; }); });
+    }
+
+    bool pop(T& out) {
+        if (mode_ == CombineMode::Never) return ring_.pop(out);
+        Record* r = my_record();
+        if (r && use_combining(*r)) {
+            bool ok = combine(*r, POP);
+            if (ok) out = r->value;
+            return ok;
+        }
+        return direct(r, [&] { return ring_.try_consume([&](T& slot) { out = slot; }); });
+    }
+
+    size_t capacity() const { return ring_.capacity(); }
+};
+
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "mpmc_queue.hpp"
+
+/*
+ * Conflating last-value-per-key queue
+ * - Fixed open-addressed table of keys, one seqlock-protected value per key
+ * - A key is enqueued on an MPMCQueue of dirty slots only on its clean -> dirty
+ *   transition, so repeated updates overwrite the pending value in place
+ * - At most maxKeys distinct keys are admitted (the table is twice that, rounded
+ *   up to a power of two, to keep probes short); consumers always read the
+ *   newest value
+ */
+
+namespace mpmc_queue {
+
+template <typename V>
+class ConflatingQueue {
+    static_assert(std::is_trivially_copyable_v<V>, "seqlock values must be trivially copyable");
+
+public:
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t(0);
+
+private:
+    static constexpr size_t WORDS = (sizeof(V) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Value is kept as relaxed atomic words so torn reads are detected by the
+    // sequence check rather than being a data race
+    struct alignas(CACHE_LINE_SIZE) Entry {
+        std::atomic<uint64_t> key{EMPTY_KEY};
+        std::atomic<uint32_t> seq{0};
+        std::atomic<bool> dirty{false};
+        std::atomic<uint64_t> words[WORDS] = {};
+    };
+
+    size_t maxKeys_;
+    size_t capacity_;
+    size_t mask_;
+    std::vector<Entry> table_;
+    MPMCQueue<uint32_t> dirty_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> keys_{0};
+
+    static size_t round_up_pow2(size_t n) {
+        size_t x = 1;
+        while (x < n) x <<= 1;
+        return x;
+    }
+
+    // Finds or claims the slot for key; nullptr when maxKeys keys are present.
+    // A key count is reserved before claiming an empty slot and returned if the
+    // claim loses, so racing inserts near the limit may spuriously fail.
+    Entry* find_or_insert(uint64_t key) {
+        size_t idx = mix_hash(key) & mask_;
+        for (size_t probe = 0; probe < capacity_; ++probe) {
+            Entry& e = table_[(idx + probe) & mask_];
+            uint64_t cur = e.key.load(std::memory_order_acquire);
+            if (cur == key) return &e;
+            if (cur == EMPTY_KEY) {
+                if (keys_.fetch_add(1, std::memory_order_relaxed) >= maxKeys_) {
+                    keys_.fetch_sub(1, std::memory_order_relaxed);
+                    return e.key.load(std::memory_order_acquire) == key ? &e : nullptr;
+                }
+                if (e.key.compare_exchange_strong(cur, key, std::memory_order_acq_rel)) return &e;
+                keys_.fetch_sub(1, std::memory_order_relaxed);
+                if (cur == key) return &e;
+            }
+        }
+        return nullptr;
+    }
+
+    void write(Entry& e, const V& value) {
+        uint64_t buf[WORDS] = {};
+        std::memcpy(buf, &value, sizeof(V));
+
+        // Writers serialise on the odd sequence; readers retry while it is odd
+        uint32_t seq = e.seq.load(std::memory_order_relaxed);
+        int spins = 0;
+        while ((seq & 1) || !e.seq.compare_exchange_weak(
+                   seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            if (++spins < 100) _mm_pause();
+            else std::this_thread::yield();
+            seq = e.seq.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) e.words[i].store(buf[i], std::memory_order_relaxed);
+        e.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    void read(const Entry& e, V& out) const {
+        uint64_t buf[WORDS];
+        // Same backoff as write(), so a reader does not burn its timeslice
+        // spinning on a writer that was preempted mid-write
+        int spins = 0;
+        while (true) {
+            uint32_t before = e.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                if (++spins < 100) _mm_pause();
+                else std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < WORDS; ++i) buf[i] = e.words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.seq.load(std::memory_order_relaxed) == before) break;
+        }
+        std::memcpy(&out, buf, sizeof(V));
+    }
+
+public:
+    // EMPTY_KEY is reserved and cannot be used as a key
+    explicit ConflatingQueue(size_t maxKeys)
+        : maxKeys_(maxKeys),
+          capacity_(round_up_pow2(maxKeys * 2)),
+          mask_(capacity_ - 1),
+          table_(capacity_),
+          dirty_(capacity_)
+    {
+        assert(maxKeys > 0);
+    }
+
+    ConflatingQueue(const ConflatingQueue&) = delete;
+    ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+
+    // Overwrites the pending value for key, enqueuing key only if it was clean.
+    // Returns false only when key is new and maxKeys keys are already present.
+    bool push(uint64_t key, const V& value) {
+        assert(key != EMPTY_KEY);
+        Entry* e = find_or_insert(key);
+        if (!e) return false;
+
+        write(*e, value);
+        if (!e->dirty.exchange(true, std::memory_order_acq_rel)) {
+            // Each slot is queued at most once, so the ring never holds more than
+            // maxKeys entries; push can still fail while a consumer is mid-pop on
+            // the tail slot, which clears as soon as it releases that slot
+            const uint32_t idx = static_cast<uint32_t>(e - table_.data());
+            int spins = 0;
+            while (!dirty_.push(idx)) {
+                if (++spins < 100) _mm_pause();
+                else std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+    // The dirty flag is cleared before the value is read, so an update that
+    // lands after the read re-enqueues the key instead of being lost
+    bool pop(uint64_t& key, V& out) {
+        uint32_t idx;
+        if (!dirty_.pop(idx)) return false;
+
+        Entry& e = table_[idx];
+        e.dirty.exchange(false, std::memory_order_acq_rel);
+        key = e.key.load(std::memory_order_relaxed);
+        read(e, out);
+        return true;
+    }
+
+    // Latest value for key without consuming it
+    bool peek(uint64_t key, V& out) const {
+        size_t idx = mix_hash(key) & mask_;
+        for (size_t probe = 0; probe < capacity_; ++probe) {
+            const Entry& e = table_[(idx + probe) & mask_];
+            uint64_t cur = e.key.load(std::memory_order_acquire);
+            if (cur == EMPTY_KEY) return false;
+            if (cur == key) {
+                if (e.seq.load(std::memory_order_acquire) == 0) return false;
+                read(e, out);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
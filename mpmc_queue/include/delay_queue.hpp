@@ -0,0 +1,258 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+#include "mpmc_queue.hpp"
+
+/*
+ * Delay / timer queue
+ * - push(item, ready_at) parks the item in a hierarchical timing wheel
+ * - One wheel per producer thread slot, each behind its own spinlock, so
+ *   inserts never share a lock unless a consumer is advancing that wheel
+ * - Consumers advance wheels to "now" and move expired buckets into an
+ *   MPMCQueue ready ring that pop() reads from
+ * - 4 levels x 256 buckets: O(1) insert, amortised O(1) expiry
+ */
+
+namespace mpmc_queue {
+
+template <typename T>
+class DelayQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr size_t LEVEL_BITS = 8;
+    static constexpr size_t SLOTS = 1 << LEVEL_BITS;
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t CHUNK = 4096;
+
+    struct Node {
+        T value;
+        uint64_t deadline;
+        Node* next;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Wheel {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        std::atomic<uint64_t> advancedTo{0};
+        std::atomic<size_t> pending{0};
+
+        uint64_t current = 0;
+        Node* slots[LEVELS][SLOTS] = {};
+        Node* overflow = nullptr;
+        // Expired but not yet accepted by a full ready ring
+        Node* spill = nullptr;
+        Node* spillTail = nullptr;
+
+        Node* freeList = nullptr;
+        std::vector<std::unique_ptr<Node[]>> chunks;
+
+        Node* alloc() {
+            if (!freeList) {
+                chunks.push_back(std::make_unique<Node[]>(CHUNK));
+                Node* chunk = chunks.back().get();
+                for (size_t i = 0; i < CHUNK; ++i) {
+                    chunk[i].next = freeList;
+                    freeList = &chunk[i];
+                }
+            }
+            Node* n = freeList;
+            freeList = n->next;
+            return n;
+        }
+
+        void release(Node* n) {
+            n->next = freeList;
+            freeList = n;
+        }
+
+        void lock_wheel() {
+            int spins = 0;
+            while (lock.test_and_set(std::memory_order_acquire)) {
+                if (++spins < 100) _mm_pause();
+                else std::this_thread::yield();
+            }
+        }
+
+        bool try_lock_wheel() { return !lock.test_and_set(std::memory_order_acquire); }
+        void unlock_wheel() { lock.clear(std::memory_order_release); }
+    };
+
+    MPMCQueue<T> ready_;
+    std::vector<Wheel> wheels_;
+    Clock::time_point epoch_;
+    Clock::duration tick_;
+
+    static size_t thread_slot() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    // Ticks are rounded up on insert and down on advance, so nothing fires early
+    uint64_t deadline_tick(Clock::time_point t) const {
+        if (t <= epoch_) return 0;
+        return static_cast<uint64_t>((t - epoch_ + tick_ - Clock::duration(1)) / tick_);
+    }
+
+    uint64_t now_tick() const {
+        return static_cast<uint64_t>((Clock::now() - epoch_) / tick_);
+    }
+
+    // Files n at the highest level where its deadline differs from current
+    static void insert(Wheel& w, Node* n) {
+        uint64_t diff = n->deadline ^ w.current;
+        size_t level = diff ? (63 - std::countl_zero(diff)) / LEVEL_BITS : 0;
+
+        if (level >= LEVELS) {
+            n->next = w.overflow;
+            w.overflow = n;
+            return;
+        }
+        Node*& slot = w.slots[level][(n->deadline >> (level * LEVEL_BITS)) & (SLOTS - 1)];
+        n->next = slot;
+        slot = n;
+    }
+
+    static void redistribute(Wheel& w, Node* list) {
+        while (list) {
+            Node* next = list->next;
+            insert(w, list);
+            list = next;
+        }
+    }
+
+    static void append_spill(Wheel& w, Node* list) {
+        while (list) {
+            Node* next = list->next;
+            list->next = nullptr;
+            if (w.spillTail) w.spillTail->next = list;
+            else w.spill = list;
+            w.spillTail = list;
+            list = next;
+        }
+    }
+
+    // Hands spilled nodes to the ready ring until it fills up
+    void flush_spill(Wheel& w) {
+        while (w.spill && ready_.push(w.spill->value)) {
+            Node* n = w.spill;
+            w.spill = n->next;
+            w.release(n);
+            w.pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (!w.spill) w.spillTail = nullptr;
+    }
+
+    // Wheel lock must be held
+    void advance(Wheel& w, uint64_t now) {
+        if (w.pending.load(std::memory_order_relaxed) == 0) {
+            w.current = std::max(w.current, now);
+            return;
+        }
+
+        while (w.current < now) {
+            ++w.current;
+            for (size_t level = LEVELS; level-- > 1; ) {
+                if (w.current & ((uint64_t(1) << (level * LEVEL_BITS)) - 1)) continue;
+                if (level == LEVELS - 1) {
+                    Node* overflow = w.overflow;
+                    w.overflow = nullptr;
+                    redistribute(w, overflow);
+                }
+                Node*& slot = w.slots[level][(w.current >> (level * LEVEL_BITS)) & (SLOTS - 1)];
+                Node* list = slot;
+                slot = nullptr;
+                redistribute(w, list);
+            }
+            Node*& slot = w.slots[0][w.current & (SLOTS - 1)];
+            append_spill(w, slot);
+            slot = nullptr;
+        }
+        flush_spill(w);
+    }
+
+public:
+    explicit DelayQueue(size_t readyCapacity,
+                        size_t numWheels = std::max(1u, std::thread::hardware_concurrency()),
+                        Clock::duration tick = std::chrono::microseconds(100))
+        : ready_(readyCapacity),
+          wheels_(numWheels),
+          epoch_(Clock::now()),
+          tick_(tick)
+    {
+        assert(numWheels > 0 && tick_.count() > 0);
+    }
+
+    DelayQueue(const DelayQueue&) = delete;
+    DelayQueue& operator=(const DelayQueue&) = delete;
+
+    // Items already due skip the wheel when the ready ring has room
+    bool push(const T& item, Clock::time_point ready_at) {
+        Wheel& w = wheels_[thread_slot() % wheels_.size()];
+        w.lock_wheel();
+
+        // An empty wheel may be far behind; catch up so the insert and the
+        // next advance stay short
+        Clock::time_point now = Clock::now();
+        if (w.pending.load(std::memory_order_relaxed) == 0) {
+            w.current = std::max(w.current, static_cast<uint64_t>((now - epoch_) / tick_));
+        }
+
+        uint64_t deadline = deadline_tick(ready_at);
+        if ((ready_at <= now || deadline <= w.current) && !w.spill && ready_.push(item)) {
+            w.unlock_wheel();
+            return true;
+        }
+
+        Node* n = w.alloc();
+        n->value = item;
+        n->deadline = std::max(deadline, w.current + 1);
+        insert(w, n);
+        w.pending.fetch_add(1, std::memory_order_relaxed);
+        w.unlock_wheel();
+        return true;
+    }
+
+    bool push_after(const T& item, Clock::duration delay) {
+        return push(item, Clock::now() + delay);
+    }
+
+    // Non-blocking: returns an item whose deadline has passed, if any. Each
+    // wheel is advanced at most once per tick; busy wheels are skipped.
+    bool pop(T& out) {
+        if (ready_.pop(out)) return true;
+
+        uint64_t now = now_tick();
+        for (Wheel& w : wheels_) {
+            if (w.advancedTo.load(std::memory_order_relaxed) >= now) continue;
+            if (w.pending.load(std::memory_order_relaxed) == 0) continue;
+            if (!w.try_lock_wheel()) continue;
+            advance(w, now);
+            w.advancedTo.store(now, std::memory_order_relaxed);
+            w.unlock_wheel();
+        }
+        return ready_.pop(out);
+    }
+
+    // Items still parked in wheels (not yet in the ready ring); approximate
+    size_t pending() const {
+        size_t total = 0;
+        for (const Wheel& w : wheels_) total += w.pending.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    Clock::duration tick() const { return tick_; }
+};
+
+}
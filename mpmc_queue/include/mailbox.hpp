@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Intrusive unbounded MPSC mailbox (Vyukov)
+ * - Messages derive from MailboxHook, so the mailbox never allocates and maps a
+ *   hook back to its message with a plain static_cast
+ * - push is a single exchange plus a release store
+ * - pop uses plain loads/stores except when it takes the last message, where
+ *   the embedded stub is re-pushed
+ * - 3 pointers in total; head/tail are deliberately not padded apart so that
+ *   thousands of mostly idle mailboxes stay small
+ */
+
+namespace mpmc_queue {
+
+// Copying a message gives the copy a fresh, unlinked hook
+struct MailboxHook {
+    std::atomic<MailboxHook*> next{nullptr};
+
+    MailboxHook() = default;
+    MailboxHook(const MailboxHook&) {}
+    MailboxHook& operator=(const MailboxHook&) { return *this; }
+};
+
+template <typename T>
+class Mailbox {
+    static_assert(std::is_base_of_v<MailboxHook, T>, "messages must derive from MailboxHook");
+
+private:
+    std::atomic<MailboxHook*> tail_;
+    MailboxHook* head_;
+    MailboxHook stub_;
+
+    static MailboxHook* hook_of(T& item) { return &item; }
+
+    // Only ever called on hooks pushed through push(T&), never on stub_
+    static T* owner_of(MailboxHook* hook) { return static_cast<T*>(hook); }
+
+    void push_hook(MailboxHook* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MailboxHook* prev = tail_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+public:
+    Mailbox() : tail_(&stub_), head_(&stub_) {}
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    // Any thread. item must stay alive and unqueued until popped.
+    void push(T& item) {
+        push_hook(hook_of(item));
+    }
+
+    // Consumer only. Returns nullptr when empty, or when the newest message's
+    // producer has swapped the tail but not yet linked it in.
+    T* pop() {
+        MailboxHook* head = head_;
+        MailboxHook* next = head->next.load(std::memory_order_acquire);
+
+        if (head == &stub_) {
+            if (!next) return nullptr;
+            head_ = next;
+            head = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            head_ = next;
+            return owner_of(head);
+        }
+
+        if (head != tail_.load(std::memory_order_acquire)) return nullptr;
+
+        push_hook(&stub_);
+        next = head->next.load(std::memory_order_acquire);
+        if (next) {
+            head_ = next;
+            return owner_of(head);
+        }
+        return nullptr;
+    }
+
+    // Consumer only. Pops up to max messages, calling fn(T&) on each in
+    // arrival order; returns the number handled.
+    template <typename F>
+    size_t drain(F&& fn, size_t max = ~size_t(0)) {
+        size_t n = 0;
+        while (n < max) {
+            T* item = pop();
+            if (!item) break;
+            fn(*item);
+            ++n;
+        }
+        return n;
+    }
+
+    // Consumer only; a message mid-push may make this report empty
+    bool empty() const {
+        return head_ == &stub_ && !stub_.next.load(std::memory_order_acquire);
+    }
+};
+
+}
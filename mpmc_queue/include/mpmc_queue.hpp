@@ -8,6 +8,11 @@
 #include <chrono>
 #include <cstddef>
 #include <optional>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
 
 /*
  * High-Performance MPMC Queue for small objects
@@ -20,18 +25,38 @@ namespace mpmc_queue {
 
 constexpr size_t CACHE_LINE_SIZE = 64;
 
-template <typename T>
-class MPMCQueue {
+enum class Kind { Single, Multi };
+
+// Outcome of a single claim attempt: Unavailable means full (push) or empty
+// (pop); Contended means another thread moved the index first
+enum class ClaimResult { Claimed, Unavailable, Contended };
+
+constexpr size_t DYNAMIC_CAPACITY = 0;
+
+/*
+ * Bounded ring specialised at compile time
+ * - Kind::Single on a side drops that side's CAS for a plain load / store-release
+ * - A non-dynamic Capacity folds the index mask into an immediate
+ * - MPMCQueue<T> is the Multi/Multi, dynamic-capacity instantiation
+ */
+template <typename T, Kind ProducerKind, Kind ConsumerKind, size_t Capacity = DYNAMIC_CAPACITY>
+class BasicRing {
 private:
+    static constexpr bool STATIC_CAPACITY = Capacity != DYNAMIC_CAPACITY;
+    static_assert(!STATIC_CAPACITY || (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be power of2");
+
     struct alignas(CACHE_LINE_SIZE) Slot {
         std::atomic<size_t> seq;
         T value;
         char pad[CACHE_LINE_SIZE - (sizeof(std::atomic<size_t>) + sizeof(T)) % CACHE_LINE_SIZE];
     };
 
+    struct Empty {};
+    using Bound = std::conditional_t<STATIC_CAPACITY, Empty, size_t>;
 
-    size_t capacity_;
-    size_t mask_;
+    [[no_unique_address]] Bound capacity_;
+    [[no_unique_address]] Bound mask_;
     std::vector<Slot> buffer_;
 
     alignas(64) std::atomic<size_t> head_;
@@ -47,8 +72,32 @@ private:
         return x;
     }
 
+    size_t cap() const {
+        if constexpr (STATIC_CAPACITY) return Capacity;
+        else return capacity_;
+    }
+
+    size_t mask() const {
+        if constexpr (STATIC_CAPACITY) return Capacity - 1;
+        else return mask_;
+    }
+
+    void init_slots() {
+        for (size_t i = 0; i < cap(); ++i) {
+            buffer_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
 public:
-    explicit MPMCQueue(size_t capacity)
+    BasicRing() requires STATIC_CAPACITY
+        : buffer_(Capacity),
+          head_(0),
+          tail_(0)
+    {
+        init_slots();
+    }
+
+    explicit BasicRing(size_t capacity) requires (!STATIC_CAPACITY)
         : capacity_(round_up_pow2(capacity)),
           mask_(capacity_ - 1),
           buffer_(capacity_),
@@ -56,102 +105,405 @@ public:
           tail_(0)
     {
         assert((capacity_ & (capacity_ - 1)) == 0 && "Capacity must be power of2");
-        for (size_t i = 0; i < capacity_; ++i) {
-            buffer_[i].seq.store(i, std::memory_order_relaxed);
-        }
+        init_slots();
     }
 
-    ~MPMCQueue() = default;
-    MPMCQueue(const MPMCQueue&) = delete;
-    MPMCQueue& operator=(const MPMCQueue&) = delete;
+    ~BasicRing() = default;
+    BasicRing(const BasicRing&) = delete;
+    BasicRing& operator=(const BasicRing&) = delete;
 
-    bool push(const T& item) {
+    size_t capacity() const { return cap(); }
+
+    // Runs fill(T&) on the claimed slot before publishing it, so the value is
+    // written straight into the ring instead of being copied in.
+    template <typename F>
+    bool push_with(F&& fill) {
         size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if constexpr (ProducerKind == Kind::Single) {
+            Slot& slot = buffer_[tail & mask()];
+            if (slot.seq.load(std::memory_order_acquire) != tail) return false;
+
+            fill(slot.value);
+            slot.seq.store(tail + 1, std::memory_order_release);
+            tail_.store(tail + 1, std::memory_order_relaxed);
+
+            _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(tail + 4) & mask()]), _MM_HINT_T0);
+
+            return true;
+        } else {
+            int spins = 0;
+
+            while (true) {
+                Slot& slot = buffer_[tail & mask()];
+                size_t seq = slot.seq.load(std::memory_order_acquire);
+                size_t diff = seq - tail;
+
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(
+                            tail, tail + 1,
+                            std::memory_order_acq_rel,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        fill(slot.value);
+                        slot.seq.store(tail + 1, std::memory_order_release);
+
+                        _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(tail + 4) & mask()]), _MM_HINT_T0);
+
+                        return true;
+                    }
+                    spins = 0;
+                } else if (diff > cap()) {
+                    return false;
+                } else {
+                    tail = tail_.load(std::memory_order_relaxed);
+                    if (++spins < 20) _mm_pause();
+                    else if (spins < 100) _mm_pause();
+                    else if (spins < 1000) std::this_thread::yield();
+                    else std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+                }
+            }
+        }
+    }
+
+    // Runs fn(T&) on the claimed slot before handing it back to producers, so
+    // the consumer reads the value in place instead of copying it out.
+    template <typename F>
+    bool consume(F&& fn) {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        if constexpr (ConsumerKind == Kind::Single) {
+            Slot& slot = buffer_[head & mask()];
+            if (slot.seq.load(std::memory_order_acquire) != head + 1) return false;
+
+            fn(slot.value);
+            slot.seq.store(head + cap(), std::memory_order_release);
+            head_.store(head + 1, std::memory_order_relaxed);
+
+            _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(head + 4) & mask()]), _MM_HINT_T0);
+
+            return true;
+        } else {
+            int spins = 0;
+
+            while (true) {
+                Slot& slot = buffer_[head & mask()];
+                size_t seq = slot.seq.load(std::memory_order_acquire);
+                size_t diff = seq - (head + 1);
+
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(
+                            head, head + 1,
+                            std::memory_order_acq_rel,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        fn(slot.value);
+                        slot.seq.store(head + cap(), std::memory_order_release);
+
+                        _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(head + 4) & mask()]), _MM_HINT_T0);
+
+                        return true;
+                    }
+                    spins = 0;
+                } else if (diff > cap()) {
+                    return false;
+                } else {
+                    head = head_.load(std::memory_order_relaxed);
+                    if (++spins < 20) _mm_pause();
+                    else if (spins < 100) _mm_pause();
+                    else if (spins < 1000) std::this_thread::yield();
+                    else std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+                }
+            }
+        }
+    }
+
+    // Claims the longest published run starting at head (up to max) with a
+    // single CAS, then runs fn(T&) on each slot in place and releases it.
+    // Returns the number of items consumed, 0 only if the slot at head was
+    // still unpublished (the queue was empty).
+    template <typename F>
+    size_t consume_bulk(F&& fn, size_t max) {
+        size_t head = head_.load(std::memory_order_relaxed);
         int spins = 0;
 
         while (true) {
-            Slot& slot = buffer_[tail & mask_];
-            size_t seq = slot.seq.load(std::memory_order_acquire);
-            size_t diff = seq - tail;
-
-            if (diff == 0) {
-                if (tail_.compare_exchange_weak(
-                        tail, tail + 1,
-                        std::memory_order_acq_rel,
-                        std::memory_order_relaxed
-                    ))
-                {
-                    slot.value = item;
-                    slot.seq.store(tail + 1, std::memory_order_release);
-
-                    _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(tail + 4) & mask_]), _MM_HINT_T0);
-
-                    return true;
-                }
-                spins = 0;
-            } else if (diff > capacity_) {
-                return false;
-            } else {
-                tail = tail_.load(std::memory_order_relaxed);
+            size_t n = 0;
+            while (n < max &&
+                   buffer_[(head + n) & mask()].seq.load(std::memory_order_acquire) == head + n + 1) {
+                ++n;
+            }
+            if (n == 0) {
+                if (max == 0) return 0;
+                size_t diff = buffer_[head & mask()].seq.load(std::memory_order_acquire) - (head + 1);
+                if (ConsumerKind == Kind::Single || diff > cap()) return 0;
+
+                // head is stale: another consumer already took that slot
+                head = head_.load(std::memory_order_relaxed);
                 if (++spins < 20) _mm_pause();
                 else if (spins < 100) _mm_pause();
                 else if (spins < 1000) std::this_thread::yield();
                 else std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+                continue;
+            }
+
+            if constexpr (ConsumerKind == Kind::Single) {
+                head_.store(head + n, std::memory_order_relaxed);
+            } else if (!head_.compare_exchange_weak(
+                           head, head + n,
+                           std::memory_order_acq_rel,
+                           std::memory_order_relaxed
+                       ))
+            {
+                _mm_pause();
+                continue;
             }
+
+            for (size_t i = 0; i < n; ++i) {
+                Slot& slot = buffer_[(head + i) & mask()];
+                fn(slot.value);
+                slot.seq.store(head + i + cap(), std::memory_order_release);
+            }
+            return n;
         }
     }
 
-    bool pop(T& out) {
-        size_t head = head_.load(std::memory_order_relaxed);
+    // Claims the longest run of free slots starting at tail (up to max) with a
+    // single CAS, then runs fill(T&, i) on the i-th slot and publishes it.
+    // Returns the number of items pushed, 0 only if the slot at tail was still
+    // unconsumed (the queue was full).
+    template <typename F>
+    size_t push_bulk_with(F&& fill, size_t max) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
         int spins = 0;
 
         while (true) {
-            Slot& slot = buffer_[head & mask_];
-            size_t seq = slot.seq.load(std::memory_order_acquire);
-            size_t diff = seq - (head + 1);
-
-            if (diff == 0) {
-                if (head_.compare_exchange_weak(
-                        head, head + 1,
-                        std::memory_order_acq_rel,
-                        std::memory_order_relaxed
-                    ))
-                {
-                    out = slot.value;
-                    slot.seq.store(head + capacity_, std::memory_order_release);
-
-                    _mm_prefetch(reinterpret_cast<const char*>(&buffer_[(head + 4) & mask_]), _MM_HINT_T0);
-
-                    return true;
-                }
-                spins = 0;
-            } else if (diff > capacity_) {
-                return false;
-            } else {
-                head = head_.load(std::memory_order_relaxed);
+            size_t n = 0;
+            while (n < max &&
+                   buffer_[(tail + n) & mask()].seq.load(std::memory_order_acquire) == tail + n) {
+                ++n;
+            }
+            if (n == 0) {
+                if (max == 0) return 0;
+                size_t diff = buffer_[tail & mask()].seq.load(std::memory_order_acquire) - tail;
+                if (ProducerKind == Kind::Single || diff > cap()) return 0;
+
+                // tail is stale: another producer already published that slot
+                tail = tail_.load(std::memory_order_relaxed);
                 if (++spins < 20) _mm_pause();
                 else if (spins < 100) _mm_pause();
                 else if (spins < 1000) std::this_thread::yield();
                 else std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+                continue;
+            }
+
+            if constexpr (ProducerKind == Kind::Single) {
+                tail_.store(tail + n, std::memory_order_relaxed);
+            } else if (!tail_.compare_exchange_weak(
+                           tail, tail + n,
+                           std::memory_order_acq_rel,
+                           std::memory_order_relaxed
+                       ))
+            {
+                _mm_pause();
+                continue;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                Slot& slot = buffer_[(tail + i) & mask()];
+                fill(slot.value, i);
+                slot.seq.store(tail + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+    }
+
+    // Single claim attempt with no spinning, so callers can observe contention
+    template <typename F>
+    ClaimResult try_push_with(F&& fill) {
+        if constexpr (ProducerKind == Kind::Single) {
+            return push_with(fill) ? ClaimResult::Claimed : ClaimResult::Unavailable;
+        } else {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            Slot& slot = buffer_[tail & mask()];
+            size_t diff = slot.seq.load(std::memory_order_acquire) - tail;
+
+            if (diff > cap()) return ClaimResult::Unavailable;
+            if (diff != 0 || !tail_.compare_exchange_strong(
+                    tail, tail + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed
+                ))
+            {
+                return ClaimResult::Contended;
+            }
+            fill(slot.value);
+            slot.seq.store(tail + 1, std::memory_order_release);
+            return ClaimResult::Claimed;
+        }
+    }
+
+    template <typename F>
+    ClaimResult try_consume(F&& fn) {
+        if constexpr (ConsumerKind == Kind::Single) {
+            return consume(fn) ? ClaimResult::Claimed : ClaimResult::Unavailable;
+        } else {
+            size_t head = head_.load(std::memory_order_relaxed);
+            Slot& slot = buffer_[head & mask()];
+            size_t diff = slot.seq.load(std::memory_order_acquire) - (head + 1);
+
+            if (diff > cap()) return ClaimResult::Unavailable;
+            if (diff != 0 || !head_.compare_exchange_strong(
+                    head, head + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed
+                ))
+            {
+                return ClaimResult::Contended;
             }
+            fn(slot.value);
+            slot.seq.store(head + cap(), std::memory_order_release);
+            return ClaimResult::Claimed;
         }
     }
+
+    bool push(const T& item) {
+        return push_with([&](T& slot) { slot = item; });
+    }
+
+    bool pop(T& out) {
+        return consume([&](T& slot) { out = slot; });
+    }
+
+    std::optional<T> pop() {
+        T out;
+        if (pop(out)) return out;
+        return std::nullopt;
+    }
 };
 
+template <typename T>
+using MPMCQueue = BasicRing<T, Kind::Multi, Kind::Multi>;
+
+template <typename T, size_t Capacity = DYNAMIC_CAPACITY>
+using SPSCRing = BasicRing<T, Kind::Single, Kind::Single, Capacity>;
+
+template <typename T, size_t Capacity = DYNAMIC_CAPACITY>
+using MPSCRing = BasicRing<T, Kind::Multi, Kind::Single, Capacity>;
+
+template <typename T, size_t Capacity = DYNAMIC_CAPACITY>
+using SPMCRing = BasicRing<T, Kind::Single, Kind::Multi, Capacity>;
+
+// MurmurHash3 fmix64; spreads weak hashes (std::hash of an integer is the
+// identity) before they are reduced to a shard, channel or bucket index
+inline size_t mix_hash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * Sharded queue with two modes
+ * - push(item) / pop(out): producers stick to a shard, any consumer pops any shard
+ * - push(key, item) / pop(consumer, out): partitioned mode, keys hash to a shard
+ *   and each shard is leased to one consumer at a time, so per-key order holds
+ *
+ * Partitioned consumers call join() for an id and leave(id) when done. Leases
+ * are reshuffled inside pop(consumer, out), i.e. only between items, towards
+ * ceil(numShards / activeConsumers) shards each; only shard counts are balanced,
+ * not per-shard load. Every pop refreshes the consumer's heartbeat, and one that
+ * has not called pop for longer than the lease duration loses its shards to the
+ * others, so per-key order across that handover is only guaranteed while it
+ * keeps calling.
+ */
 template <typename T>
 class ShardedMPMCQueue {
+public:
+    // Returned by join() when all maxConsumers slots are taken
+    static constexpr size_t NO_CONSUMER = ~size_t(0);
+
 private:
+    static constexpr size_t NO_OWNER = NO_CONSUMER;
+    static constexpr size_t REBALANCE_INTERVAL = 64;
+
+    struct alignas(CACHE_LINE_SIZE) ShardOwner {
+        std::atomic<size_t> id{NO_OWNER};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerLease {
+        std::atomic<bool> active{false};
+        std::atomic<uint64_t> heartbeat{0};
+        // Touched only by the consumer holding this lease
+        std::vector<size_t> owned;
+        size_t cursor = 0;
+        size_t calls = 0;
+    };
+
     std::vector<std::unique_ptr<MPMCQueue<T>>> shards_;
     size_t numShards_;
     std::atomic<size_t> nextShard_{0};
 
+    std::vector<ShardOwner> owners_;
+    std::vector<ConsumerLease> leases_;
+    alignas(64) std::atomic<size_t> activeConsumers_{0};
+    uint64_t leaseNs_ = 100'000'000;
+
     static thread_local size_t localShard_;
     static thread_local bool hasShard_;
 
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // A heartbeat at or after now (refreshed since we read the clock) is live
+    bool expired(size_t consumer) const {
+        uint64_t hb = leases_[consumer].heartbeat.load(std::memory_order_relaxed);
+        uint64_t now = now_ns();
+        return hb < now && now - hb > leaseNs_;
+    }
+
+    void rebalance(size_t consumer) {
+        ConsumerLease& lease = leases_[consumer];
+
+        // Drop shards taken over after our lease expired
+        std::erase_if(lease.owned, [&](size_t s) {
+            return owners_[s].id.load(std::memory_order_acquire) != consumer;
+        });
+
+        size_t active = std::max<size_t>(1, activeConsumers_.load(std::memory_order_acquire));
+        size_t target = (numShards_ + active - 1) / active;
+
+        while (lease.owned.size() > target) {
+            owners_[lease.owned.back()].id.store(NO_OWNER, std::memory_order_release);
+            lease.owned.pop_back();
+        }
+
+        for (size_t n = 0; n < numShards_ && lease.owned.size() < target; ++n) {
+            size_t s = (consumer * target + n) % numShards_;
+            size_t cur = owners_[s].id.load(std::memory_order_acquire);
+            if (cur == consumer) continue;
+
+            bool claimable = cur == NO_OWNER ||
+                !leases_[cur].active.load(std::memory_order_acquire) || expired(cur);
+            if (claimable && owners_[s].id.compare_exchange_strong(
+                    cur, consumer, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                lease.owned.push_back(s);
+            }
+        }
+    }
+
 
 public:
-    explicit ShardedMPMCQueue(size_t numShards, size_t capacityPerShard)
-        : numShards_(numShards)
+    explicit ShardedMPMCQueue(size_t numShards, size_t capacityPerShard, size_t maxConsumers = 64)
+        : numShards_(numShards),
+          owners_(numShards),
+          leases_(maxConsumers)
     {
         assert(numShards_ > 0);
         shards_.reserve(numShards_);
@@ -182,8 +534,71 @@ public:
         return false;
     }
 
+    // Partitioned mode: every item for key lands in the same shard
+    template <typename Key>
+    bool push(const Key& key, const T& item) {
+        return shards_[mix_hash(std::hash<Key>{}(key)) % numShards_]->push(item);
+    }
+
+    // Returns a consumer id for pop(consumer, out), or NO_CONSUMER if all
+    // maxConsumers slots are taken
+    size_t join() {
+        for (size_t i = 0; i < leases_.size(); ++i) {
+            bool expected = false;
+            if (leases_[i].active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                leases_[i].heartbeat.store(now_ns(), std::memory_order_relaxed);
+                leases_[i].owned.clear();
+                leases_[i].calls = 0;
+                activeConsumers_.fetch_add(1, std::memory_order_acq_rel);
+                return i;
+            }
+        }
+        return NO_CONSUMER;
+    }
+
+    void leave(size_t consumer) {
+        assert(consumer < leases_.size());
+        ConsumerLease& lease = leases_[consumer];
+        for (size_t s : lease.owned) {
+            size_t expected = consumer;
+            owners_[s].id.compare_exchange_strong(expected, NO_OWNER, std::memory_order_release);
+        }
+        lease.owned.clear();
+        activeConsumers_.fetch_sub(1, std::memory_order_acq_rel);
+        lease.active.store(false, std::memory_order_release);
+    }
+
+    // Pops only from shards leased to consumer. Items already returned must be
+    // fully processed before the next call, since that call may hand shards over.
+    // Shards are visited round-robin, one item each, so a hot shard cannot
+    // starve the others.
+    bool pop(size_t consumer, T& out) {
+        assert(consumer < leases_.size());
+        ConsumerLease& lease = leases_[consumer];
+        lease.heartbeat.store(now_ns(), std::memory_order_relaxed);
+        if (lease.calls++ % REBALANCE_INTERVAL == 0) rebalance(consumer);
+
+        size_t owned = lease.owned.size();
+        for (size_t n = 0; n < owned; ++n) {
+            size_t i = (lease.cursor + n) % owned;
+            size_t s = lease.owned[i];
+            // Taken over after our lease expired; rebalance drops it next call
+            if (owners_[s].id.load(std::memory_order_acquire) != consumer) {
+                lease.calls = 0;
+                continue;
+            }
+            if (shards_[s]->pop(out)) {
+                lease.cursor = i + 1;
+                return true;
+            }
+        }
+        lease.calls = 0;
+        return false;
+    }
 
+    size_t owned_shards(size_t consumer) const { return leases_[consumer].owned.size(); }
 
+    void set_lease(std::chrono::nanoseconds lease) { leaseNs_ = lease.count(); }
 };
 
 template <typename T>
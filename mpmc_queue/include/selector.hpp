@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "mpmc_queue.hpp"
+
+/*
+ * Fan-in wait over many MPMCQueues
+ * - One ready bit per registered queue, set by producers when the bit is clear
+ * - The consumer clears a bit only after finding that queue empty, then rechecks
+ * - When every bit is clear the consumer parks on one futex (std::atomic::wait)
+ * - Single consumer: select/try_select/try_pop/pop advance a plain cursor and
+ *   clear ready bits, so they must all be called from one consumer thread.
+ *   push/notify may be called from any producer thread, close() from any thread
+ */
+
+namespace mpmc_queue {
+
+enum class SelectOrder { Priority, Fair };
+
+template <typename T>
+class Selector {
+private:
+    struct alignas(CACHE_LINE_SIZE) ReadyWord {
+        std::atomic<uint64_t> bits{0};
+    };
+
+    std::vector<MPMCQueue<T>*> queues_;
+    std::vector<ReadyWord> ready_;
+    // Consumer thread only
+    size_t cursor_ = 0;
+
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    std::atomic<bool> waiting_{false};
+    std::atomic<bool> closed_{false};
+
+    // Fills out with ready ids, visiting ids from start upward and wrapping
+    size_t scan(size_t start, size_t* out, size_t max) const {
+        const size_t words = ready_.size();
+        size_t n = 0;
+        size_t w = start / 64;
+        uint64_t bits = ready_[w].bits.load(std::memory_order_seq_cst) & (~0ULL << (start % 64));
+
+        for (size_t visited = 0; visited <= words && n < max; ) {
+            while (bits && n < max) {
+                size_t id = w * 64 + std::countr_zero(bits);
+                bits &= bits - 1;
+                if (visited == words && id >= start) return n;
+                out[n++] = id;
+            }
+            ++visited;
+            w = (w + 1) % words;
+            bits = ready_[w].bits.load(std::memory_order_seq_cst);
+        }
+        return n;
+    }
+
+    void wake() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_seq_cst)) epoch_.notify_all();
+    }
+
+public:
+    explicit Selector(size_t maxQueues)
+        : ready_((maxQueues + 63) / 64)
+    {
+        assert(maxQueues > 0);
+        queues_.reserve(maxQueues);
+    }
+
+    Selector(const Selector&) = delete;
+    Selector& operator=(const Selector&) = delete;
+
+    // Registration is not thread-safe; register everything before producers start.
+    // Lower ids are served first under SelectOrder::Priority.
+    size_t add(MPMCQueue<T>& q) {
+        assert(queues_.size() < ready_.size() * 64);
+        queues_.push_back(&q);
+        return queues_.size() - 1;
+    }
+
+    size_t size() const { return queues_.size(); }
+    MPMCQueue<T>& queue(size_t id) { return *queues_[id]; }
+
+    // Call after pushing to queue id directly. Costs one fence and a load while
+    // the bit is already set; only the clear-to-set transition writes the word.
+    void notify(size_t id) {
+        std::atomic<uint64_t>& word = ready_[id / 64].bits;
+        const uint64_t bit = 1ULL << (id % 64);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (word.load(std::memory_order_relaxed) & bit) return;
+        if (!(word.fetch_or(bit, std::memory_order_seq_cst) & bit)) wake();
+    }
+
+    bool push(size_t id, const T& item) {
+        if (!queues_[id]->push(item)) return false;
+        notify(id);
+        return true;
+    }
+
+    // Non-blocking: fills ready with up to max ids whose queues may be non-empty
+    size_t try_select(size_t* ready, size_t max, SelectOrder order = SelectOrder::Fair) {
+        size_t n = scan(order == SelectOrder::Fair ? cursor_ : 0, ready, max);
+        if (n && order == SelectOrder::Fair) cursor_ = (ready[n - 1] + 1) % (ready_.size() * 64);
+        return n;
+    }
+
+    // Blocks until at least one queue is ready. Returns 0 only after close().
+    size_t select(size_t* ready, size_t max, SelectOrder order = SelectOrder::Fair) {
+        while (true) {
+            size_t n = try_select(ready, max, order);
+            if (n) return n;
+            if (closed_.load(std::memory_order_acquire)) return 0;
+
+            waiting_.store(true, std::memory_order_seq_cst);
+            uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+            n = try_select(ready, max, order);
+            if (n == 0 && !closed_.load(std::memory_order_acquire)) {
+                epoch_.wait(epoch, std::memory_order_seq_cst);
+            }
+            waiting_.store(false, std::memory_order_relaxed);
+            if (n) return n;
+        }
+    }
+
+    // Pops from queue id. On failure the ready bit is cleared, then the queue
+    // is checked once more so a push racing with the clear is not lost.
+    bool try_pop(size_t id, T& out) {
+        if (queues_[id]->pop(out)) return true;
+
+        std::atomic<uint64_t>& word = ready_[id / 64].bits;
+        const uint64_t bit = 1ULL << (id % 64);
+        word.fetch_and(~bit, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (queues_[id]->pop(out)) {
+            word.fetch_or(bit, std::memory_order_seq_cst);
+            return true;
+        }
+        return false;
+    }
+
+    // Blocks until an item is available from any queue. Returns false only after close().
+    bool pop(T& out, SelectOrder order = SelectOrder::Fair) {
+        size_t id;
+        while (select(&id, 1, order)) {
+            if (try_pop(id, out)) return true;
+        }
+        return false;
+    }
+
+    // Wakes a blocked consumer and makes select() return 0 once nothing is ready
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+    }
+};
+
+}
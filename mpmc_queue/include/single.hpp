@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include <cstddef>
 #include <cmath>
@@ -53,3 +54,93 @@ public:
         return true;
     }
 };
+
+struct alignas(64) PaddedAtomicIndex {
+    std::atomic<size_t> value{0};
+};
+
+/*
+ * Thread-safe single-producer / single-consumer variant of CircularQueue.
+ * Same layout, but head/tail are published with acquire/release so one
+ * producer thread and one consumer thread can share the ring.
+ */
+template <typename T>
+class SPSCQueue {
+    size_t capacity_;
+    size_t mask_;
+    std::vector<PaddedT<T>> buffer_;
+
+    PaddedAtomicIndex head_;
+    PaddedAtomicIndex tail_;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t x = 1;
+        while (x < n) x <<= 1;
+        return x;
+    }
+
+public:
+    // One slot always stays empty to tell full from empty, so the buffer is
+    // sized for capacity + 1 and at least capacity items fit
+    explicit SPSCQueue(size_t capacity)
+        : capacity_(round_up_pow2(capacity + 1))
+        , mask_(capacity_ - 1)
+        , buffer_(capacity_)
+    {
+        assert(capacity > 0);
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    bool push(const T& item) {
+        size_t tail = tail_.value.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & mask_;
+
+        if (next == head_.value.load(std::memory_order_acquire)) return false;
+
+        size_t prefetch_idx = (tail + 4) & mask_;
+        __builtin_prefetch(&buffer_[prefetch_idx], 1, 3);
+
+        buffer_[tail].value = item;
+        tail_.value.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        size_t head = head_.value.load(std::memory_order_relaxed);
+        if (head == tail_.value.load(std::memory_order_acquire)) return false;
+
+        size_t prefetch_idx = (head + 4) & mask_;
+        __builtin_prefetch(&buffer_[prefetch_idx], 0, 3);
+
+        out = buffer_[head].value;
+        head_.value.store((head + 1) & mask_, std::memory_order_release);
+        return true;
+    }
+
+    // Drains up to max items with a single acquire of tail and a single
+    // release of head.
+    size_t pop_bulk(T* out, size_t max) {
+        size_t head = head_.value.load(std::memory_order_relaxed);
+        size_t tail = tail_.value.load(std::memory_order_acquire);
+        size_t n = (tail - head) & mask_;
+        if (n > max) n = max;
+
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = buffer_[(head + i) & mask_].value;
+        }
+        if (n) head_.value.store((head + n) & mask_, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate when called concurrently; exact from either owning thread
+    // for its own side.
+    size_t size() const {
+        size_t tail = tail_.value.load(std::memory_order_acquire);
+        size_t head = head_.value.load(std::memory_order_acquire);
+        return (tail - head) & mask_;
+    }
+
+    size_t capacity() const { return capacity_ - 1; }
+};
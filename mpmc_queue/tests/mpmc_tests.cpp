@@ -1,4 +1,10 @@
 #include "mpmc_queue.hpp"
+#include "channel_mesh.hpp"
+#include "selector.hpp"
+#include "delay_queue.hpp"
+#include "conflating_queue.hpp"
+#include "mailbox.hpp"
+#include "combining_queue.hpp"
 #include <gtest/gtest.h>
 #include <thread>
 #include <vector>
@@ -176,6 +182,767 @@ TEST(MPMCQueueTest, HighContentionStress) {
     EXPECT_EQ(unique.size(), results.size());
 }
 
+TEST(MPMCQueueTest, PushWithConsumeInPlace) {
+    MPMCQueue<std::pair<int, int>> q(4);
+    EXPECT_TRUE(q.push_with([](std::pair<int, int>& v) { v.first = 1; v.second = 2; }));
+    int sum = 0;
+    EXPECT_TRUE(q.consume([&](const std::pair<int, int>& v) { sum = v.first + v.second; }));
+    EXPECT_EQ(sum, 3);
+    EXPECT_FALSE(q.consume([](std::pair<int, int>&) {}));
+}
+
+TEST(MPMCQueueTest, ConsumeBulkTakesPublishedRun) {
+    MPMCQueue<int> q(8);
+    for (int i = 0; i < 6; ++i) EXPECT_TRUE(q.push(i));
+    std::vector<int> seen;
+    EXPECT_EQ(q.consume_bulk([&](int v) { seen.push_back(v); }, 4), 4u);
+    EXPECT_EQ(q.consume_bulk([&](int v) { seen.push_back(v); }, 4), 2u);
+    EXPECT_EQ(q.consume_bulk([&](int v) { seen.push_back(v); }, 4), 0u);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(q.push(i));
+    EXPECT_FALSE(q.push(8));
+}
+
+TEST(MPMCQueueTest, ConsumeBulkMultipleProducersMultipleConsumers) {
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int items_per_producer = 5000;
+    MPMCQueue<int> q(256);
+    std::atomic<int> consumed{0};
+    std::vector<int> results;
+    std::mutex results_mutex;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([p, &q]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                while (!q.push_with([&](int& v) { v = p * items_per_producer + i; }))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([&]() {
+            std::vector<int> local;
+            while (consumed.load() < num_producers * items_per_producer) {
+                local.clear();
+                size_t n = q.consume_bulk([&](int v) { local.push_back(v); }, 16);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results.insert(results.end(), local.begin(), local.end());
+                consumed += n;
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    EXPECT_EQ(results.size(), num_producers * items_per_producer);
+    std::unordered_set<int> unique(results.begin(), results.end());
+    EXPECT_EQ(unique.size(), results.size());
+}
+
+TEST(MPMCQueueTest, ConsumeBulkNeverReportsEmptyWhileItemsRemain) {
+    const int num_consumers = 4;
+    const int total_items = 1 << 16;
+    MPMCQueue<int> q(total_items);
+    for (int i = 0; i < total_items; ++i) ASSERT_TRUE(q.push(i));
+    std::atomic<bool> spurious_empty{false};
+    std::vector<std::thread> consumers;
+    // Each consumer stops at its share of half the items, so the queue is
+    // never empty and a 0 return can only come from a stale head
+    for (int c = 0; c < num_consumers; ++c) {
+        consumers.emplace_back([&]() {
+            int taken = 0;
+            while (taken < total_items / 2 / num_consumers) {
+                size_t n = q.consume_bulk([](int) {}, 1 + taken % 4);
+                if (n == 0) spurious_empty = true;
+                taken += static_cast<int>(n);
+            }
+        });
+    }
+    for (auto &t : consumers) t.join();
+    EXPECT_FALSE(spurious_empty.load());
+}
+
+TEST(BasicRingTest, StaticCapacitySPSC) {
+    SPSCRing<int, 4> q;
+    EXPECT_EQ(q.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.push(i));
+    EXPECT_FALSE(q.push(4));
+    for (int i = 0; i < 4; ++i) {
+        auto v = q.pop();
+        ASSERT_TRUE(v.has_value());
+        EXPECT_EQ(v.value(), i);
+    }
+    EXPECT_FALSE(q.pop().has_value());
+    EXPECT_TRUE(q.push(5));
+    EXPECT_EQ(q.consume_bulk([](int v) { EXPECT_EQ(v, 5); }, 8), 1u);
+}
+
+TEST(BasicRingTest, DynamicCapacityRoundsUp) {
+    SPMCRing<int> q(5);
+    EXPECT_EQ(q.capacity(), 8u);
+    MPMCQueue<int> m(3);
+    EXPECT_EQ(m.capacity(), 4u);
+}
+
+TEST(BasicRingTest, MultipleProducersSingleConsumer) {
+    const int num_producers = 4;
+    const int items_per_producer = 5000;
+    MPSCRing<int, 128> q;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([p, &q]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                while (!q.push(p * items_per_producer + i)) std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<int> last(num_producers, -1);
+    int consumed = 0;
+    while (consumed < num_producers * items_per_producer) {
+        int v;
+        if (!q.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_GT(v % items_per_producer, last[v / items_per_producer]);
+        last[v / items_per_producer] = v % items_per_producer;
+        ++consumed;
+    }
+    for (auto &t : producers) t.join();
+    EXPECT_FALSE(q.pop().has_value());
+}
+
+TEST(BasicRingTest, SingleProducerMultipleConsumers) {
+    const int num_consumers = 4;
+    const int total_items = 20000;
+    SPMCRing<int> q(64);
+    std::atomic<int> consumed{0};
+    std::vector<int> results;
+    std::mutex results_mutex;
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < num_consumers; ++c) {
+        consumers.emplace_back([&]() {
+            while (consumed.load() < total_items) {
+                int v;
+                if (q.pop(v)) {
+                    std::lock_guard<std::mutex> lock(results_mutex);
+                    results.push_back(v);
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < total_items; ++i) {
+        while (!q.push(i)) std::this_thread::yield();
+    }
+    for (auto &t : consumers) t.join();
+    EXPECT_EQ(results.size(), total_items);
+    std::unordered_set<int> unique(results.begin(), results.end());
+    EXPECT_EQ(unique.size(), results.size());
+}
+
+TEST(SelectorTest, PriorityAndFairOrder) {
+    std::vector<std::unique_ptr<MPMCQueue<int>>> queues;
+    Selector<int> sel(100);
+    for (int i = 0; i < 100; ++i) {
+        queues.push_back(std::make_unique<MPMCQueue<int>>(4));
+        EXPECT_EQ(sel.add(*queues.back()), static_cast<size_t>(i));
+    }
+    EXPECT_TRUE(sel.push(70, 70));
+    EXPECT_TRUE(sel.push(3, 3));
+    EXPECT_TRUE(sel.push(65, 65));
+
+    size_t ready[8];
+    ASSERT_EQ(sel.try_select(ready, 8, SelectOrder::Priority), 3u);
+    EXPECT_EQ(ready[0], 3u);
+    EXPECT_EQ(ready[1], 65u);
+    EXPECT_EQ(ready[2], 70u);
+
+    ASSERT_EQ(sel.try_select(ready, 1, SelectOrder::Fair), 1u);
+    EXPECT_EQ(ready[0], 3u);
+    ASSERT_EQ(sel.try_select(ready, 1, SelectOrder::Fair), 1u);
+    EXPECT_EQ(ready[0], 65u);
+    ASSERT_EQ(sel.try_select(ready, 8, SelectOrder::Fair), 3u);
+    EXPECT_EQ(ready[0], 70u);
+    EXPECT_EQ(ready[1], 3u);
+    EXPECT_EQ(ready[2], 65u);
+}
+
+TEST(SelectorTest, TryPopClearsReadyBit) {
+    MPMCQueue<int> a(4), b(4);
+    Selector<int> sel(2);
+    sel.add(a);
+    sel.add(b);
+    EXPECT_TRUE(sel.push(1, 42));
+    int v;
+    EXPECT_TRUE(sel.try_pop(1, v));
+    EXPECT_EQ(v, 42);
+    size_t ready[2];
+    EXPECT_EQ(sel.try_select(ready, 2), 1u);
+    EXPECT_FALSE(sel.try_pop(1, v));
+    EXPECT_EQ(sel.try_select(ready, 2), 0u);
+
+    EXPECT_TRUE(a.push(7));
+    sel.notify(0);
+    EXPECT_TRUE(sel.pop(v));
+    EXPECT_EQ(v, 7);
+}
+
+TEST(SelectorTest, BlockingPopAndClose) {
+    const int num_queues = 64;
+    const int num_producers = 4;
+    const int items_per_producer = 2000;
+    std::vector<std::unique_ptr<MPMCQueue<int>>> queues;
+    Selector<int> sel(num_queues);
+    for (int i = 0; i < num_queues; ++i) {
+        queues.push_back(std::make_unique<MPMCQueue<int>>(16));
+        sel.add(*queues.back());
+    }
+    const size_t total_items = num_producers * items_per_producer;
+    std::vector<int> results;
+    bool popped_after_close = true;
+    // Only the consumer touches the selector's consumer side, including close()
+    std::thread consumer([&]() {
+        int v;
+        while (results.size() < total_items && sel.pop(v)) results.push_back(v);
+        sel.close();
+        popped_after_close = sel.pop(v);
+    });
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([p, &sel]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                int v = p * items_per_producer + i;
+                while (!sel.push(v % num_queues, v)) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : producers) t.join();
+    consumer.join();
+    EXPECT_EQ(results.size(), total_items);
+    EXPECT_FALSE(popped_after_close);
+    std::unordered_set<int> unique(results.begin(), results.end());
+    EXPECT_EQ(unique.size(), results.size());
+}
+
+TEST(ShardedMPMCQueueTest, PartitionedLeasesRebalanceOnJoin) {
+    ShardedMPMCQueue<int> q(8, 64);
+    size_t c0 = q.join();
+    int v;
+    EXPECT_FALSE(q.pop(c0, v));
+    EXPECT_EQ(q.owned_shards(c0), 8u);
+    for (int k = 0; k < 32; ++k) EXPECT_TRUE(q.push(k, k));
+    int popped = 0;
+    while (q.pop(c0, v)) ++popped;
+    EXPECT_EQ(popped, 32);
+
+    size_t c1 = q.join();
+    EXPECT_NE(c0, c1);
+    EXPECT_FALSE(q.pop(c0, v));
+    EXPECT_EQ(q.owned_shards(c0), 4u);
+    EXPECT_FALSE(q.pop(c1, v));
+    EXPECT_EQ(q.owned_shards(c1), 4u);
+
+    q.leave(c0);
+    EXPECT_FALSE(q.pop(c1, v));
+    EXPECT_EQ(q.owned_shards(c1), 8u);
+}
+
+TEST(ShardedMPMCQueueTest, JoinFailsWhenConsumerSlotsAreTaken) {
+    ShardedMPMCQueue<int> q(4, 16, 2);
+    size_t c0 = q.join();
+    size_t c1 = q.join();
+    EXPECT_NE(c0, ShardedMPMCQueue<int>::NO_CONSUMER);
+    EXPECT_NE(c1, ShardedMPMCQueue<int>::NO_CONSUMER);
+    EXPECT_EQ(q.join(), ShardedMPMCQueue<int>::NO_CONSUMER);
+    q.leave(c0);
+    EXPECT_EQ(q.join(), c0);
+}
+
+TEST(ShardedMPMCQueueTest, ExpiredLeaseOwnerStopsPoppingTakenShards) {
+    ShardedMPMCQueue<int> q(4, 64);
+    size_t c0 = q.join();
+    int v;
+    EXPECT_FALSE(q.pop(c0, v));
+    for (int k = 0; k < 64; ++k) EXPECT_TRUE(q.push(k, k));
+    EXPECT_TRUE(q.pop(c0, v));
+
+    q.set_lease(std::chrono::milliseconds(10));
+    size_t c1 = q.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    int by_c1 = q.pop(c1, v) ? 1 : 0;
+    EXPECT_EQ(q.owned_shards(c1), 2u);
+
+    // c0 still caches all four shards but must skip the two c1 took over
+    int by_c0 = 1;
+    while (q.pop(c0, v)) ++by_c0;
+    EXPECT_EQ(q.owned_shards(c0), 2u);
+    while (q.pop(c1, v)) ++by_c1;
+    EXPECT_GT(by_c1, 1);
+    EXPECT_EQ(by_c0 + by_c1, 64);
+}
+
+TEST(ShardedMPMCQueueTest, PartitionedPerKeyOrder) {
+    const int num_producers = 4;
+    const int num_consumers = 3;
+    const int keys_per_producer = 16;
+    const int items_per_producer = 8000;
+    const int total_items = num_producers * items_per_producer;
+    ShardedMPMCQueue<std::pair<int, int>> q(16, 256);
+    std::vector<std::atomic<int>> last(num_producers * keys_per_producer);
+    for (auto &l : last) l.store(-1);
+    std::atomic<int> consumed{0};
+    std::atomic<bool> in_order{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([p, &q]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                int key = p * keys_per_producer + i % keys_per_producer;
+                while (!q.push(key, {key, i})) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([c, &q, &last, &consumed, &in_order]() {
+            size_t id = q.join();
+            int handled = 0;
+            std::pair<int, int> v;
+            while (consumed.load() < total_items) {
+                // One consumer leaves half way and rejoins to force handovers
+                if (c == 0 && handled == 2000) {
+                    q.leave(id);
+                    id = q.join();
+                    ++handled;
+                }
+                if (!q.pop(id, v)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (last[v.first].load(std::memory_order_acquire) >= v.second) in_order = false;
+                last[v.first].store(v.second, std::memory_order_release);
+                ++handled;
+                ++consumed;
+            }
+            q.leave(id);
+        });
+    }
+    for (auto &t : threads) t.join();
+    EXPECT_EQ(consumed.load(), total_items);
+    EXPECT_TRUE(in_order.load());
+}
+
+TEST(DelayQueueTest, HoldsItemsUntilDeadline) {
+    using Clock = DelayQueue<int>::Clock;
+    DelayQueue<int> q(64, 2, std::chrono::milliseconds(1));
+    auto now = Clock::now();
+    EXPECT_TRUE(q.push(1, now));
+    EXPECT_TRUE(q.push(3, now + std::chrono::milliseconds(40)));
+    EXPECT_TRUE(q.push_after(2, std::chrono::milliseconds(10)));
+
+    int v;
+    ASSERT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_FALSE(q.pop(v));
+    EXPECT_EQ(q.pending(), 2u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    ASSERT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 2);
+    EXPECT_FALSE(q.pop(v));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ASSERT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 3);
+    EXPECT_EQ(q.pending(), 0u);
+}
+
+TEST(DelayQueueTest, NeverFiresEarlyAcrossLevels) {
+    using Clock = DelayQueue<int64_t>::Clock;
+    const int num_producers = 4;
+    const int items_per_producer = 2000;
+    // 1us ticks so 0-200ms delays cascade through three wheel levels
+    DelayQueue<int64_t> q(256, 2, std::chrono::microseconds(1));
+    auto base = Clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([p, base, &q]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                auto due = base + std::chrono::microseconds((i * 7919 + p * 131) % 200'000);
+                q.push(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    due.time_since_epoch()).count(), due);
+            }
+        });
+    }
+    for (auto &t : producers) t.join();
+
+    int popped = 0;
+    bool early = false;
+    while (popped < num_producers * items_per_producer) {
+        int64_t due;
+        if (!q.pop(due)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+        if (now < due) early = true;
+        ++popped;
+    }
+    EXPECT_FALSE(early);
+    EXPECT_EQ(q.pending(), 0u);
+}
+
+TEST(DelayQueueTest, SpillsWhenReadyRingIsFull) {
+    using Clock = DelayQueue<int>::Clock;
+    DelayQueue<int> q(4, 1, std::chrono::microseconds(100));
+    auto due = Clock::now() + std::chrono::milliseconds(1);
+    for (int i = 0; i < 20; ++i) q.push(i, due);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::unordered_set<int> seen;
+    auto give_up = Clock::now() + std::chrono::seconds(5);
+    while (seen.size() < 20 && Clock::now() < give_up) {
+        int v;
+        if (q.pop(v)) seen.insert(v);
+        else std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_EQ(seen.size(), 20u);
+}
+
+struct Quote {
+    int first;
+    double second;
+};
+
+TEST(ConflatingQueueTest, OverwritesPendingValue) {
+    ConflatingQueue<Quote> q(4);
+    EXPECT_TRUE(q.push(7, {1, 1.5}));
+    EXPECT_TRUE(q.push(9, {2, 2.5}));
+    EXPECT_TRUE(q.push(7, {3, 3.5}));
+
+    uint64_t key;
+    Quote v;
+    ASSERT_TRUE(q.pop(key, v));
+    EXPECT_EQ(key, 7u);
+    EXPECT_EQ(v.first, 3);
+    ASSERT_TRUE(q.pop(key, v));
+    EXPECT_EQ(key, 9u);
+    EXPECT_EQ(v.first, 2);
+    EXPECT_FALSE(q.pop(key, v));
+
+    EXPECT_TRUE(q.push(9, {4, 4.5}));
+    ASSERT_TRUE(q.peek(9, v));
+    EXPECT_EQ(v.first, 4);
+    EXPECT_FALSE(q.peek(8, v));
+}
+
+TEST(ConflatingQueueTest, BoundedByKeyCount) {
+    ConflatingQueue<int> q(2);
+    int inserted = 0;
+    for (uint64_t k = 0; k < 16; ++k) inserted += q.push(k, static_cast<int>(k));
+    EXPECT_EQ(inserted, 2);
+    EXPECT_TRUE(q.push(0, 100));
+    EXPECT_FALSE(q.push(99, 1));
+}
+
+TEST(ConflatingQueueTest, ConsumerSeesMonotonicLatestValues) {
+    const int num_producers = 4;
+    const int keys_per_producer = 8;
+    const int64_t updates = 20000;
+    struct Tick { int64_t seq; int64_t check; };
+    ConflatingQueue<Tick> q(num_producers * keys_per_producer);
+    std::atomic<int> producers_done{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([p, &q, &producers_done]() {
+            for (int64_t i = 1; i <= updates; ++i) {
+                uint64_t key = p * keys_per_producer + i % keys_per_producer;
+                q.push(key, {i, -i});
+            }
+            ++producers_done;
+        });
+    }
+    std::vector<int64_t> last(num_producers * keys_per_producer, 0);
+    bool ok = true;
+    auto drain = [&]() {
+        uint64_t key;
+        Tick t;
+        while (q.pop(key, t)) {
+            if (t.check != -t.seq || t.seq < last[key]) ok = false;
+            last[key] = t.seq;
+        }
+    };
+    while (producers_done.load() < num_producers) {
+        drain();
+        std::this_thread::yield();
+    }
+    for (auto &t : producers) t.join();
+    drain();
+    EXPECT_TRUE(ok);
+    for (int k = 0; k < num_producers * keys_per_producer; ++k) {
+        EXPECT_EQ(last[k], updates - (updates - k % keys_per_producer) % keys_per_producer);
+    }
+}
+
+struct Letter : MailboxHook {
+    int from;
+    int seq;
+};
+
+using LetterBox = Mailbox<Letter>;
+
+TEST(MailboxTest, FifoAndDrain) {
+    LetterBox box;
+    EXPECT_EQ(sizeof(box), 3 * sizeof(void*));
+    EXPECT_TRUE(box.empty());
+    EXPECT_EQ(box.pop(), nullptr);
+
+    std::vector<Letter> letters(5);
+    for (int i = 0; i < 5; ++i) {
+        letters[i].seq = i;
+        box.push(letters[i]);
+    }
+    EXPECT_FALSE(box.empty());
+    Letter* first = box.pop();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, &letters[0]);
+
+    std::vector<int> seen;
+    EXPECT_EQ(box.drain([&](Letter& l) { seen.push_back(l.seq); }, 2), 2u);
+    EXPECT_EQ(box.drain([&](Letter& l) { seen.push_back(l.seq); }), 2u);
+    EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_TRUE(box.empty());
+
+    // Reusing a popped message and the stub cycling back in
+    box.push(*first);
+    EXPECT_EQ(box.pop(), first);
+    EXPECT_EQ(box.pop(), nullptr);
+}
+
+TEST(MailboxTest, MultipleProducersPerProducerOrder) {
+    const int num_producers = 4;
+    const int items_per_producer = 20000;
+    LetterBox box;
+    std::vector<std::vector<Letter>> letters(num_producers, std::vector<Letter>(items_per_producer));
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([p, &box, &letters]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                letters[p][i].from = p;
+                letters[p][i].seq = i;
+                box.push(letters[p][i]);
+            }
+        });
+    }
+    std::vector<int> next(num_producers, 0);
+    int received = 0;
+    bool in_order = true;
+    while (received < num_producers * items_per_producer) {
+        size_t n = box.drain([&](Letter& l) {
+            if (l.seq != next[l.from]) in_order = false;
+            next[l.from] = l.seq + 1;
+        }, 64);
+        if (n == 0) std::this_thread::yield();
+        received += n;
+    }
+    for (auto &t : producers) t.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(box.pop(), nullptr);
+}
+
+TEST(MPMCQueueTest, PushBulkAndTryClaims) {
+    MPMCQueue<int> q(4);
+    EXPECT_EQ(q.push_bulk_with([](int& slot, size_t i) { slot = static_cast<int>(i); }, 8), 4u);
+    EXPECT_EQ(q.try_push_with([](int& slot) { slot = 9; }), ClaimResult::Unavailable);
+    int v = -1;
+    EXPECT_EQ(q.try_consume([&](int& slot) { v = slot; }), ClaimResult::Claimed);
+    EXPECT_EQ(v, 0);
+    EXPECT_EQ(q.try_push_with([](int& slot) { slot = 9; }), ClaimResult::Claimed);
+    std::vector<int> seen;
+    EXPECT_EQ(q.consume_bulk([&](int x) { seen.push_back(x); }, 8), 4u);
+    EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 9}));
+    EXPECT_EQ(q.try_consume([](int&) {}), ClaimResult::Unavailable);
+}
+
+TEST(CombiningQueueTest, FullAndEmptyInEveryMode) {
+    for (CombineMode mode : {CombineMode::Adaptive, CombineMode::Always, CombineMode::Never}) {
+        CombiningMPMCQueue<int> q(2, mode);
+        int v;
+        EXPECT_FALSE(q.pop(v));
+        EXPECT_TRUE(q.push(1));
+        EXPECT_TRUE(q.push(2));
+        EXPECT_FALSE(q.push(3));
+        ASSERT_TRUE(q.pop(v));
+        EXPECT_EQ(v, 1);
+        ASSERT_TRUE(q.pop(v));
+        EXPECT_EQ(v, 2);
+        EXPECT_FALSE(q.pop(v));
+    }
+}
+
+TEST(CombiningQueueTest, MultipleProducersMultipleConsumers) {
+    const int num_producers = 8;
+    const int num_consumers = 8;
+    const int items_per_producer = 5000;
+    for (CombineMode mode : {CombineMode::Adaptive, CombineMode::Always}) {
+        // Fewer records than threads so the overflow path is exercised too
+        CombiningMPMCQueue<int> q(128, mode, 12);
+        std::atomic<int> consumed{0};
+        std::vector<int> results;
+        std::mutex results_mutex;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < num_producers; ++p) {
+            threads.emplace_back([p, &q]() {
+                for (int i = 0; i < items_per_producer; ++i) {
+                    while (!q.push(p * items_per_producer + i)) std::this_thread::yield();
+                }
+            });
+        }
+        for (int c = 0; c < num_consumers; ++c) {
+            threads.emplace_back([&]() {
+                std::vector<int> local;
+                while (consumed.load() < num_producers * items_per_producer) {
+                    int v;
+                    if (q.pop(v)) {
+                        local.push_back(v);
+                        ++consumed;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results.insert(results.end(), local.begin(), local.end());
+            });
+        }
+        for (auto &t : threads) t.join();
+        EXPECT_EQ(results.size(), num_producers * items_per_producer);
+        std::unordered_set<int> unique(results.begin(), results.end());
+        EXPECT_EQ(unique.size(), results.size());
+    }
+}
+
+TEST(CombiningQueueTest, HalfFullRingNeverReportsFullOrEmpty) {
+    const int num_threads = 8;
+    const int capacity = 1 << 17;
+    const int rounds = 6000;
+    for (CombineMode mode : {CombineMode::Adaptive, CombineMode::Always}) {
+        // Fewer records than threads, so direct-path threads move head/tail
+        // while the combiner runs its bulk claims
+        CombiningMPMCQueue<int> q(capacity, mode, 4);
+        for (int i = 0; i < capacity / 2; ++i) ASSERT_TRUE(q.push(i));
+        std::atomic<bool> spurious{false};
+        std::vector<std::thread> threads;
+        // Every thread pushes one item then pops one. Fewer than capacity / 2
+        // pushes in total, so tail only reaches never-used slots and head only
+        // prefilled ones: a false can only come from a stale index, not from a
+        // slot held by a preempted thread
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([t, &q, &spurious]() {
+                int v;
+                for (int i = 0; i < rounds; ++i) {
+                    if (!q.push(t * rounds + i)) spurious = true;
+                    if (!q.pop(v)) spurious = true;
+                }
+            });
+        }
+        for (auto &t : threads) t.join();
+        EXPECT_FALSE(spurious.load());
+    }
+}
+
+TEST(ChannelMeshTest, RoundRobinSpreadsAcrossConsumers) {
+    ChannelMesh<int> mesh(1, 4, 8);
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(mesh.push(0, i));
+    for (size_t c = 0; c < 4; ++c) {
+        int a, b;
+        ASSERT_TRUE(mesh.pop(c, a));
+        ASSERT_TRUE(mesh.pop(c, b));
+        EXPECT_EQ(a, static_cast<int>(c));
+        EXPECT_EQ(b, static_cast<int>(c) + 4);
+        EXPECT_FALSE(mesh.pop(c, a));
+    }
+}
+
+TEST(ChannelMeshTest, KeyedPreservesPerKeyOrder) {
+    ChannelMesh<std::pair<int, int>> mesh(1, 3, 64);
+    for (int i = 0; i < 30; ++i) EXPECT_TRUE(mesh.push_keyed(0, i % 5, {i % 5, i}));
+    std::vector<int> last(5, -1);
+    size_t total = 0;
+    for (size_t c = 0; c < 3; ++c) {
+        std::pair<int, int> v;
+        while (mesh.pop(c, v)) {
+            EXPECT_GT(v.second, last[v.first]);
+            last[v.first] = v.second;
+            ++total;
+        }
+    }
+    EXPECT_EQ(total, 30u);
+}
+
+TEST(ChannelMeshTest, LeastLoadedAndBulkDrain) {
+    ChannelMesh<int> mesh(1, 4, 16, 4);
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(mesh.push_least_loaded(0, i));
+    int buf[16];
+    EXPECT_EQ(mesh.pop_bulk(0, buf, 16), 2u);
+    EXPECT_TRUE(mesh.push_least_loaded(0, 100));
+    EXPECT_EQ(mesh.pop_bulk(0, buf, 16), 1u);
+    EXPECT_EQ(buf[0], 100);
+    EXPECT_EQ(mesh.pop_bulk(1, buf, 16), 2u);
+}
+
+TEST(ChannelMeshTest, ChannelHoldsRequestedCapacity) {
+    ChannelMesh<int> single(1, 1, 1);
+    EXPECT_TRUE(single.push(0, 1));
+    EXPECT_FALSE(single.push(0, 2));
+
+    ChannelMesh<int> mesh(1, 1, 64);
+    for (int i = 0; i < 64; ++i) EXPECT_TRUE(mesh.push(0, i));
+    int buf[64];
+    EXPECT_EQ(mesh.pop_bulk(0, buf, 64), 64u);
+}
+
+TEST(ChannelMeshTest, MultipleProducersMultipleConsumers) {
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int items_per_producer = 5000;
+    ChannelMesh<int> mesh(num_producers, num_consumers, 64);
+    std::atomic<int> consumed{0};
+    std::vector<int> results;
+    std::mutex results_mutex;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([p, &mesh]() {
+            for (int i = 0; i < items_per_producer; ++i) {
+                while (!mesh.push(p, p * items_per_producer + i)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < num_consumers; ++c) {
+        threads.emplace_back([c, &mesh, &consumed, &results, &results_mutex]() {
+            int buf[32];
+            while (consumed.load() < num_producers * items_per_producer) {
+                size_t n = mesh.pop_bulk(c, buf, 32);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results.insert(results.end(), buf, buf + n);
+                consumed += n;
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    EXPECT_EQ(results.size(), num_producers * items_per_producer);
+    std::unordered_set<int> unique(results.begin(), results.end());
+    EXPECT_EQ(unique.size(), results.size());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();